@@ -1,1260 +1,5746 @@
-
-#include<Siv3D.hpp>
-#include<HamFramework.hpp>
-
-namespace Yeah {
-	namespace Scenes { class IScene; }
-	namespace Transitions { class ITransition; }
-	class SceneChanger;
-}
-
-class SceneFactory {
-public:
-	template<typename T, typename...Args>
-	static std::unique_ptr<Yeah::Scenes::IScene> Create(Args&&...args);
-};
-namespace Yeah {
-	namespace Scenes {
-		class IScene {
-			friend class SceneChanger;
-
-			struct {
-				bool exit_ = false;
-				Optional<std::pair<std::unique_ptr<IScene>, std::unique_ptr<Transitions::ITransition>>> change_;
-				Optional<std::unique_ptr<Transitions::ITransition>> undo_;
-				Optional<std::unique_ptr<Transitions::ITransition>> redo_;
-
-				void resetOptional() {
-					change_.reset();
-					undo_.reset();
-					redo_.reset();
-				}
-			} request_;
-		public:
-			virtual ~IScene() {}
-			virtual void initialize() {}	//シーンが呼ばれたとき(undo・redoでも呼ばれる)
-
-			virtual void update() = 0;
-			virtual void draw() const = 0;
-
-			virtual void updateFadeIn(double /*t*/) { update(); }
-			virtual void updateFadeOut(double /*t*/) { update(); }
-			virtual void drawFadeIn(double /*t*/) const { draw(); }
-			virtual void drawFadeOut(double /*t*/) const { draw(); }
-
-			void exit() {
-				request_.exit_ = true;
-			}
-			void changeScene(std::unique_ptr<IScene>&& scene,
-				std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
-				request_.change_ = std::make_pair(std::move(scene), std::move(transition));
-			}
-			void undo(std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
-				request_.undo_ = std::move(transition);
-			}
-			void redo(std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
-				request_.redo_ = std::move(transition);
-			}
-		};
-	}
-}
-
-class TransitionFactory {
-public:
-	template<typename T, typename...Args>
-	static std::unique_ptr<Yeah::Transitions::ITransition> Create(Args&&...args);
-};
-namespace Yeah {
-	namespace Transitions {
-		class ITransition {
-		public:
-			virtual ~ITransition() = default;
-			virtual void update(const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) = 0;
-			virtual void draw(const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) const = 0;
-
-			virtual Optional<std::unique_ptr<ITransition>> nextTransition() const = 0;
-		};
-
-		class Step :public ITransition {
-		public:
-			void update([[maybe_unused]] const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) override {
-				if (after) {
-					after->update();
-				}
-			}
-			void draw([[maybe_unused]] const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) const override {
-				if (after) {
-					after->draw();
-				}
-			}
-
-			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
-				return none;
-			}
-		};
-
-		class AlphaFadeOut :public ITransition {
-			Timer timer;
-		public:
-			AlphaFadeOut(const Duration& fadeOutTime) :
-				timer(fadeOutTime, true) {}
-			void update(const std::unique_ptr<Scenes::IScene>& before,
-				[[maybe_unused]] const std::unique_ptr<Scenes::IScene>& after) override {
-				if (before) {
-					const ScopedColorMul2D s(1.0, timer.progress1_0());
-					before->updateFadeOut(timer.progress1_0());
-				}
-			}
-			void draw(const std::unique_ptr<Scenes::IScene>& before,
-				[[maybe_unused]] const std::unique_ptr<Scenes::IScene>& after) const override {
-				if (before) {
-					const ScopedColorMul2D s(1.0, timer.progress1_0());
-					before->drawFadeOut(timer.progress1_0());
-				}
-			}
-
-			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
-				if (timer.reachedZero()) {
-					return Optional<std::unique_ptr<ITransition>>(TransitionFactory::Create<Transitions::Step>());
-				}
-				else {
-					return none;
-				}
-			}
-		};
-
-		class AlphaFadeIn :public ITransition {
-			Timer timer;
-		public:
-			AlphaFadeIn(const Duration& fadeInTime) :
-				timer(fadeInTime, true) {}
-			void update([[maybe_unused]] const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) override {
-				if (after) {
-					const ScopedColorMul2D s(1.0, timer.progress0_1());
-					after->updateFadeIn(timer.progress0_1());
-				}
-			}
-			void draw([[maybe_unused]] const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) const override {
-				if (after) {
-					const ScopedColorMul2D s(1.0, timer.progress0_1());
-					after->drawFadeIn(timer.progress0_1());
-				}
-			}
-
-			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
-				if (timer.reachedZero()) {
-					return Optional<std::unique_ptr<ITransition>>(TransitionFactory::Create<Transitions::Step>());
-				}
-				else {
-					return none;
-				}
-			}
-		};
-
-		class AlphaFadeInOut :public ITransition {
-			Timer timer;
-			const Duration fadeOutTime, fadeInTime;
-		public:
-			AlphaFadeInOut(const Duration& fadeOutTime, const Duration& fadeInTime) :
-				timer(fadeOutTime + fadeInTime, true),
-				fadeInTime(fadeInTime),
-				fadeOutTime(fadeOutTime) {}
-			void update(const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) override {
-				if (timer.remaining() < fadeInTime) {
-					if (after) {
-						const ScopedColorMul2D s(1.0, (fadeInTime - timer.remaining()) / fadeInTime);
-						after->updateFadeIn((fadeInTime - timer.remaining()) / fadeInTime);
-					}
-				}
-				else {
-					if (before) {
-						const ScopedColorMul2D s(1.0, (timer.remaining() - fadeInTime) / fadeOutTime);
-						before->updateFadeOut((timer.remaining() - fadeInTime) / fadeOutTime);
-					}
-				}
-			}
-			void draw(const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) const override {
-				if (timer.remaining() < fadeInTime) {
-					if (after) {
-						const ScopedColorMul2D s(1.0, (fadeInTime - timer.remaining()) / fadeInTime);
-						after->drawFadeIn((fadeInTime - timer.remaining()) / fadeInTime);
-					}
-				}
-				else {
-					if (before) {
-						const ScopedColorMul2D s(1.0, (timer.remaining() - fadeInTime) / fadeOutTime);
-						before->drawFadeOut((timer.remaining() - fadeInTime) / fadeOutTime);
-					}
-				}
-			}
-
-			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
-				if (timer.reachedZero()) {
-					return Optional<std::unique_ptr<ITransition>>(TransitionFactory::Create<Transitions::Step>());
-				}
-				else {
-					return none;
-				}
-			}
-		};
-
-		class CrossFade :public ITransition {
-			Timer timer;
-		public:
-			CrossFade(const Duration& fadeTime) :
-				timer(fadeTime, true) {}
-			void update(const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) override {
-				if (after) {
-					const ScopedColorMul2D mul(1.0, timer.progress0_1());
-					after->updateFadeIn(timer.progress0_1());
-				}
-				if (before) {
-					const ScopedColorMul2D mul(1.0, timer.progress1_0());
-					before->updateFadeOut(timer.progress1_0());
-				}
-			}
-			void draw(const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) const override {
-				if (after) {
-					const ScopedColorMul2D mul(1.0, timer.progress0_1());
-					after->drawFadeIn(timer.progress0_1());
-				}
-				if (before) {
-					const ScopedColorMul2D mul(1.0, timer.progress1_0());
-					before->drawFadeOut(timer.progress1_0());
-				}
-			}
-
-			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
-				if (timer.reachedZero()) {
-					return Optional<std::unique_ptr<ITransition>>(TransitionFactory::Create<Transitions::Step>());
-				}
-				else {
-					return none;
-				}
-			}
-		};
-
-		template<typename FadeOutT, typename FadeInT>
-		class CustomFadeInOut :public ITransition {
-			Timer timer;
-			const Duration fadeOutTime, fadeInTime;
-			Optional<FadeOutT> fadeOut;
-			Optional<FadeInT> fadeIn;
-		public:
-			CustomFadeInOut(const Duration& fadeOutTime, const Duration& fadeInTime) :
-				timer(fadeOutTime + fadeInTime, true),
-				fadeInTime(fadeInTime),
-				fadeOutTime(fadeOutTime),
-				fadeOut(FadeOutT{ fadeOutTime }) {}
-			void update(const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) override {
-				if (not fadeIn && timer.remaining() < fadeInTime) {
-					fadeIn.emplace(fadeInTime);
-				}
-				if (timer.remaining() < fadeInTime) {
-					if (fadeIn) {
-						fadeIn->update(before, after);
-					}
-				}
-				else {
-					if (fadeOut) {
-						fadeOut->update(before, after);
-					}
-				}
-			}
-			void draw(const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) const override {
-				if (timer.remaining() < fadeInTime) {
-					if (fadeIn) {
-						fadeIn->draw(before, after);
-					}
-				}
-				else {
-					if (fadeOut) {
-						fadeOut->draw(before, after);
-					}
-				}
-			}
-
-			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
-				if (timer.reachedZero()) {
-					return Optional<std::unique_ptr<ITransition>>(TransitionFactory::Create<Transitions::Step>());
-				}
-				else {
-					return none;
-				}
-			}
-		};
-
-		template<typename FadeOutT, typename FadeInT>
-		class CustomCrossFade :public ITransition {
-			Timer timer;
-			FadeOutT fadeOut;
-			FadeInT fadeIn;
-		public:
-			CustomCrossFade(const Duration& fadeTime) :
-				timer(fadeTime, true),
-				fadeOut(FadeOutT{ fadeTime }),
-				fadeIn(FadeInT{ fadeTime }) {}
-			void update(const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) override {
-				fadeIn.update(before, after);
-				fadeOut.update(before, after);
-			}
-			void draw(const std::unique_ptr<Scenes::IScene>& before,
-				const std::unique_ptr<Scenes::IScene>& after) const override {
-				fadeIn.draw(before, after);
-				fadeOut.draw(before, after);
-			}
-
-			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
-				if (timer.reachedZero()) {
-					return Optional<std::unique_ptr<ITransition>>(TransitionFactory::Create<Transitions::Step>());
-				}
-				else {
-					return none;
-				}
-			}
-		};
-	}
-}
-
-namespace Yeah {
-	class SceneChanger {
-		Array<std::unique_ptr<Scenes::IScene>> scenes_;
-		Optional<int64> before_index_, after_index_;
-		std::unique_ptr<Transitions::ITransition> transition_ = TransitionFactory::Create<Transitions::CrossFade>(1s);
-	public:
-		SceneChanger() = default;
-		SceneChanger(
-			std::unique_ptr<Scenes::IScene>&& scene,
-			std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
-			change(std::move(scene), std::move(transition));
-		}
-
-		void setTransition(std::unique_ptr<Transitions::ITransition>&& transition) {
-			if (not transition) { return; }
-
-			transition_ = std::move(transition);
-		}
-		void change(std::unique_ptr<Scenes::IScene>&& next, std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
-			if (not next) { return; }
-
-			if (after_index_) {
-				scenes_.dropBack(scenes_.size() - 1 - *after_index_);
-			}
-
-			scenes_ << std::move(next);
-
-			before_index_ = after_index_;
-			if (after_index_) {
-				++(*after_index_);
-			}
-			else {
-				after_index_ = 0;
-			}
-			
-			if (after()) {
-				after()->initialize();
-			}
-
-			setTransition(std::move(transition));
-		}
-		void redo(std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
-			if (not after_index_) { return; }
-			if (scenes_.size() <= *after_index_ + 1) { return; }
-
-			before_index_ = after_index_;
-			++(*after_index_);
-
-			if (after()) {
-				after()->initialize();
-			}
-
-			setTransition(std::move(transition));
-		}
-		void undo(std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
-			if (not after_index_) { return; }
-			if (*after_index_ <= 0) { return; }
-
-			before_index_ = after_index_;
-			--(*after_index_);
-
-			if (after()) {
-				after()->initialize();
-			}
-
-			setTransition(std::move(transition));
-		}
-
-		bool update() {
-			if (transition_) {
-				transition_->update(before(), after());
-			}
-
-			if (after()) {
-				if (after()->request_.change_) {
-					change(
-						std::move(after()->request_.change_->first),
-						std::move(after()->request_.change_->second)
-					);
-				}
-				if (after()->request_.undo_) {
-					undo(std::move(*after()->request_.undo_));
-				}
-				if (after()->request_.redo_) {
-					redo(std::move(*after()->request_.redo_));
-				}
-			}
-			if (after()) {
-				after()->request_.resetOptional();
-			}
-			if (before()) {
-				before()->request_.resetOptional();
-			}
-
-			//if (KeyU.down()) {
-			//	undo(TransitionFactory::Create<Transitions::AlphaFadeInOut>(0.4s, 0.4s));
-			//}
-			//if (KeyR.down()) {
-			//	redo(TransitionFactory::Create<Transitions::AlphaFadeInOut>(0.4s, 0.4s));
-			//}
-
-			if (transition_) {
-				if (auto&& i = transition_->nextTransition(); i.has_value()) {
-					setTransition(std::move(*i));
-				}
-			}
-
-			return after() ? not after()->request_.exit_ : true;
-		}
-		void draw() const {
-			if (transition_) {
-				transition_->draw(before(), after());
-			}
-		}
-
-	private:
-		std::unique_ptr<Yeah::Scenes::IScene>& before() {
-			static std::unique_ptr<Yeah::Scenes::IScene> nul{ nullptr };
-			return before_index_ ? scenes_[*before_index_] : nul;
-		}
-		const std::unique_ptr<Yeah::Scenes::IScene>& before() const {
-			static std::unique_ptr<Yeah::Scenes::IScene> nul{ nullptr };
-			return before_index_ ? scenes_[*before_index_] : nul;
-		}
-		std::unique_ptr<Yeah::Scenes::IScene>& after() {
-			static std::unique_ptr<Yeah::Scenes::IScene> nul{ nullptr };
-			return after_index_ ? scenes_[*after_index_] : nul;
-		}
-		const std::unique_ptr<Yeah::Scenes::IScene>& after() const {
-			static std::unique_ptr<Yeah::Scenes::IScene> nul{ nullptr };
-			return after_index_ ? scenes_[*after_index_] : nul;
-		}
-	};
-}
-
-/*シーンの前方宣言*/
-namespace Master {
-	class Title;
-}
-namespace Second {
-	class Title;
-}
-namespace ConwaysGameOfLife {
-	class Title;
-	class Game;
-}
-namespace BreakOut {
-	class Title;
-	class Game;
-	class Game2;
-	class Result;
-}
-namespace FindShape {
-	class Title;
-	class GameScene1;
-	class GameScene2;
-	class Result;
-	class Answer;
-}
-namespace TenSecondsTimer {
-	class Title;
-	class Rule;
-	class Game;
-	class Result;
-}
-
-/*シーン実装*/
-namespace Master {
-	class Title :public Yeah::Scenes::IScene {
-		const Font font{ 100 };
-	public:
-		void update() override {
-			if (SimpleGUI::ButtonAt(U"ライフゲーム", { 400,350 }, 200)) {
-				changeScene(
-					SceneFactory::Create<ConwaysGameOfLife::Title>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"ブロック崩し", { 400,400 }, 200)) {
-				changeScene(
-					SceneFactory::Create<BreakOut::Title>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"供養ゲーム", { 400,450 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Second::Title>(),
-					TransitionFactory::Create<Yeah::Transitions::CustomFadeInOut<Yeah::Transitions::AlphaFadeOut, Yeah::Transitions::AlphaFadeIn>>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"終了", { 400,500 }, 200)) {
-				exit();
-			}
-		}
-		void draw() const override {
-			font(U"MiniGames").drawAt({ 400,180 });
-		}
-	};
-}
-namespace Second {
-	class Title :public Yeah::Scenes::IScene {
-		const Font font{ 100 };
-	public:
-		void update() override {
-			if (SimpleGUI::ButtonAt(U"図形探し", { 400,350 }, 200)) {
-				changeScene(
-					SceneFactory::Create<FindShape::Title>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"10秒タイマー", { 400,400 }, 200, true)) {
-				changeScene(
-					SceneFactory::Create<TenSecondsTimer::Title>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"", { 400,450 }, 200, false)) {
-			}
-			if (SimpleGUI::ButtonAt(U"戻る", { 400,500 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Master::Title>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-		}
-		void draw() const override {
-			font(U"MiniGames").drawAt({ 400,180 });
-		}
-	};
-}
-namespace ConwaysGameOfLife {
-	class Impl {	//ライフゲーム本体
-	public:
-		Grid<bool> cell_;
-
-		Impl(const Size& size, bool value = false) :
-			cell_(size, value) {}
-		void update() {
-			Grid<int32> countAround(cell_.size(), 0);
-			for (const auto& p : step(cell_.size())) {
-				for (const auto& i : step(Point(-1, -1), Size(3, 3))) {
-					if (i.isZero()) {
-						continue;
-					}
-					countAround[p] += cell_.fetch(p + i, false);
-				}
-			}
-			Grid<bool> tmp(cell_.size());
-			for (const auto& p : step(cell_.size())) {
-				tmp[p] = (countAround[p] == 3) || (countAround[p] == 2 && cell_[p]);
-			}
-			cell_ = std::move(tmp);
-		}
-		void draw() const {
-			for (const auto& p : step(cell_.size())) {
-				RectF(p, 1).draw(cell_[p] ? Palette::Yellow : Palette::Gray).drawFrame(0.05, 0.0, Palette::Black);
-			}
-		}
-	};
-
-	class Title :public Yeah::Scenes::IScene {
-		Impl impl_{ Size(40,30) };
-		Timer timer{ 2s,true };
-		const Font font{ 100 };
-	public:
-		Title() {
-			for (auto&& i : impl_.cell_) {
-				i = RandomBool(0.3);
-			}
-		}
-		void update() override {
-			impl_.update();
-			if (timer.reachedZero()) {
-				for (auto&& i : impl_.cell_) {
-					i = RandomBool(0.3);
-				}
-				timer.restart();
-			}
-
-			if (SimpleGUI::ButtonAt(U"スタート", { 400,400 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Game>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"戻る", { 400,450 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Master::Title>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-		}
-		void draw() const override {
-			{
-				const Transformer2D t(Mat3x2::Translate(-10, -7.5).scaled(40));
-				const ScopedColorMul2D s(1.0, 0.1);
-				impl_.draw();
-			}
-			font(U"ライフゲーム").drawAt({ 400,180 });
-		}
-	};
-	class Game :public Yeah::Scenes::IScene {
-		Impl impl_{ Size(30,30) };
-		bool auto_ = false;
-	public:
-		void update() override {
-			{
-				const Transformer2D t(Mat3x2::Scale(20), true);
-				for (const auto& p : step(impl_.cell_.size())) {
-					if (const auto& region = RectF(p, 1); region.leftPressed()) {
-						impl_.cell_[p] = true;
-					}
-					else if (region.rightPressed()) {
-						impl_.cell_[p] = false;
-					}
-				}
-			}
-
-			if (SimpleGUI::ButtonAt(U"次へ", { 700,50 }, 160, not auto_)) {
-				impl_.update();
-			}
-			SimpleGUI::CheckBoxAt(auto_, U"オート", { 700,100 }, 160);
-			if (auto_) {
-				impl_.update();
-			}
-			if (SimpleGUI::ButtonAt(U"ランダム", { 700,200 }, 160)) {
-				const double chance = Random(0.1, 0.5);
-				for (auto&& i : impl_.cell_) {
-					i = RandomBool(chance);
-				}
-			}
-			if (SimpleGUI::ButtonAt(U"リセット", { 700,250 }, 160)) {
-				impl_.cell_.fill(false);
-			}
-
-			if (SimpleGUI::ButtonAt(U"戻る", { 700,550 }, 160) || KeyB.down()) {
-				undo(TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s));
-			}
-		}
-		void draw() const override {
-			const Transformer2D t(Mat3x2::Scale(20), true);
-			impl_.draw();
-		}
-	};
-}
-namespace BreakOut {
-	class Impl {	//ゲーム本体の実装
-	public:
-		struct Block {
-			RectF region;
-			ColorF color;
-			int32 life;
-
-			void draw() const {
-				region.stretched(-1).draw(color);
-			}
-		};
-		Size block_size_{ 40,25 };
-		Size blocks_num_{ 16,7 };
-		static constexpr Point blocks_center{ 400,150 };
-		double ball_speed = 400.0;
-		Array<Block> blocks_;
-		Vec2 ball_vel_ = Vec2::Zero();
-		Circle ball_{ 0,0,8 };
-		RectF paddle_{ 0,0,60,10 };
-		int32 score_ = 0;
-		Stopwatch sw;
-
-		bool hold = true;
-
-		Impl(const Size& block_size, const Size& blocks_num):
-			block_size_(block_size),
-			blocks_num_(blocks_num) {
-			for (const auto& i : step(blocks_num_)) {
-				blocks_ << Block{ RectF(Arg::center = blocks_center - (i - (blocks_num_ - Vec2::One()) / 2.0) * block_size_,block_size_),RandomColorF(),1 };
-			}
-		}
-
-		bool update() {
-			paddle_.setPos(Arg::center = Vec2{ Cursor::PosF().x, 500 });
-
-			if (hold && MouseL.down()) {
-				hold = false;
-				ball_vel_ = Vec2::Up(ball_speed);
-				sw.start();
-			}
-
-			if (hold) {
-				ball_.setPos(Arg::bottomCenter = paddle_.topCenter());
-				ball_vel_ = Vec2::Zero();
-			}
-			else {
-				ball_.moveBy(ball_vel_ * Scene::DeltaTime());
-			}
-
-			for (auto i = begin(blocks_); i != end(blocks_); ++i) {
-				if (i->region.intersects(ball_)) {
-					if (i->region.right().intersects(ball_) || i->region.left().intersects(ball_)) {
-						ball_vel_.x *= -1;
-					}
-					if (i->region.top().intersects(ball_) || i->region.bottom().intersects(ball_)) {
-						ball_vel_.y *= -1;
-					}
-
-					if (--(i->life) <= 0) {
-						blocks_.erase(i);
-						++score_;
-						ball_speed += 5;
-					}
-					break;
-				}
-			}
-
-			if ((ball_.x < 0 && ball_vel_.x < 0) || (800 < ball_.x && ball_vel_.x > 0)) {
-				ball_vel_.x *= -1;
-			}
-			if (ball_.y < 0 && ball_vel_.y < 0) {
-				ball_vel_.y *= -1;
-			}
-			if (ball_vel_.y > 0 && paddle_.intersects(ball_)) {
-				ball_vel_ = Vec2((ball_.x - paddle_.center().x) * 10, -ball_vel_.y).setLength(ball_speed);
-			}
-
-			ball_vel_.setLength(ball_speed);
-
-			if (ball_.y > 600) {
-				return false;
-			}
-			if (blocks_.empty()) {
-				return false;
-			}
-
-			return true;
-		}
-		void draw() const {
-			for (const auto& i : blocks_) {
-				i.draw();
-			}
-			ball_.draw();
-			paddle_.draw();
-		}
-	};
-
-	class Title :public Yeah::Scenes::IScene {
-		const Font font{ 100 };
-		Impl impl_{ {40,25},{16,7} };
-	public:
-		void update() override {
-			if (SimpleGUI::ButtonAt(U"スタート", { 400,350 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Game>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			{
-				const ScopedColorMul2D s(1.0, 0.0);
-				if (SimpleGUI::ButtonAt(U"ハード", { 400,400 }, 200)) {
-					changeScene(
-						SceneFactory::Create<Game2>(),
-						TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-					);
-				}
-			}
-			if (SimpleGUI::ButtonAt(U"戻る", { 400,450 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Master::Title>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-		}
-		void draw() const override {
-			{
-				const Transformer2D t(Mat3x2::Translate(0, 150).scaled(3, {400,150}));
-				const ScopedColorMul2D s(1.0, 0.1);
-				impl_.draw();
-			}
-			font(U"ブロック崩し").drawAt({ 400,180 }, Palette::White);
-		}
-	};
-	class Game :public Yeah::Scenes::IScene {
-		Impl impl_{ {40,25},{16,7} };
-	public:
-		void update() override {
-			if (not impl_.update()) {
-				changeScene(
-					SceneFactory::Create<Result>(impl_.score_, impl_.sw.elapsed(), SceneFactory::Create<Game>),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-		}
-		void draw() const override {
-			impl_.draw();
-		}
-	};
-	class Game2 :public Yeah::Scenes::IScene {
-		Impl impl_{ {20,10},{35,20} };
-	public:
-		void update() override {
-			if (not impl_.update()) {
-				changeScene(
-					SceneFactory::Create<Result>(impl_.score_, impl_.sw.elapsed(), SceneFactory::Create<Game2>),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-		}
-		void draw() const override {
-			impl_.draw();
-		}
-	};
-
-	class Result :public Yeah::Scenes::IScene {
-		const Font font{ 100 };
-		int32 score_;
-		Duration duration_;
-		std::unique_ptr<Yeah::Scenes::IScene>(*factory_)();
-	public:
-		Result(int32 score, const Duration& duration, std::unique_ptr<Yeah::Scenes::IScene>(*factory)()) :
-			score_(score),
-			duration_(duration),
-			factory_(factory) {}
-		void update() override {
-			if (SimpleGUI::ButtonAt(U"もう一度", { 400,450 }, 200)) {
-				changeScene(
-					factory_(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"戻る", { 400,500 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Title>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-		}
-		void draw() const override {
-			font(U"スコア:{}"_fmt(score_)).drawAt({ 400,180 });
-			font(U"タイム:{:.2f}s"_fmt(duration_.count())).drawAt({ 400,300 });
-		}
-	};
-}
-namespace FindShape {
-	class Title :public Yeah::Scenes::IScene {
-		const Font font{ 100 };
-	public:
-		void update() override {
-			if (SimpleGUI::ButtonAt(U"イージー", { 400,350 }, 200)) {
-				changeScene(
-					SceneFactory::Create<GameScene1>(50),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"ノーマル", { 400,400 }, 200)) {
-				changeScene(
-					SceneFactory::Create<GameScene1>(100),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"ハード", { 400,450 }, 200)) {
-				changeScene(
-					SceneFactory::Create<GameScene1>(200),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"戻る", { 400,500 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Second::Title>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-		}
-		void draw() const override {
-			font(U"図形を探せ！").drawAt({ 400,180 });
-		}
-	};
-
-	struct Shape {
-		Polygon polygon;
-		ColorF color;
-	};
-	Array<Shape> shapes;
-	int32 target_index;
-	Optional<int32> grab_index;	//クリック
-	Optional<int32> hold_index;	//0.15秒以上ホールド
-	class GameScene1 :public Yeah::Scenes::IScene {
-		const Font font{ 100 };
-		Timer timer{ 3s,true };
-		int32 shapenum_;
-	public:
-		GameScene1(int32 shapenum) :
-			shapenum_(shapenum) {}
-		void initialize() override {
-			timer.restart();
-
-			shapes.clear();
-			for ([[maybe_unused]] int i : step(shapenum_)) {
-				const Vec2 center = RandomVec2(Rect(0, 0, 800, 600));
-				const double angle = Random(Math::TwoPi);
-				const ColorF color = RandomColorF();
-				switch (Random(3)) {
-				case 0:
-				{
-					const Triangle triangle(center, 100);
-					shapes << Shape{ triangle.rotatedAt(center,angle).asPolygon(),color };
-					break;
-				}
-				case 1:
-				{
-					const RectF rect(Arg::center = center, 60, 80);
-					shapes << Shape{ rect.rotatedAt(center,angle).asPolygon(),color };
-					break;
-				}
-				case 2:
-				{
-					const auto star = Shape2D::Star(50, center, angle);
-					shapes << Shape{ star.asPolygon(),color };
-					break;
-				}
-				case 3:
-				{
-					const auto plus = Shape2D::Plus(50, 20, center, angle);
-					shapes << Shape{ plus.asPolygon(),color };
-					break;
-				}
-				}
-			}
-			target_index = Random(shapes.size() - 1);
-			grab_index = hold_index = none;
-		}
-
-		void update() override {
-			if (timer.reachedZero()) {
-				changeScene(
-					SceneFactory::Create<GameScene2>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.1s, 0.1s)
-				);
-			}
-		}
-		void draw() const override {
-			font(U"探せ！").drawAt({ 400,200 });
-			const auto& target = shapes[target_index];
-			target.polygon.movedBy(-target.polygon.centroid()).scaled(0.6 * (2 + Periodic::Sine0_1(2s))).movedBy(Vec2(400, 400)).draw(target.color);
-		}
-	};
-	class GameScene2 :public Yeah::Scenes::IScene {
-		const Font font{ 100 };
-		Optional<int32> mouseover_index;
-	public:
-		void update() override {
-			mouseover_index = none;
-			for (const auto& [i, s] : IndexedReversed(shapes)) {
-				const auto& [polygon, color] = s;
-				if (polygon.leftClicked()) {
-					grab_index = i;
-				}
-				if (grab_index && MouseL.pressedDuration() > 0.15s) {
-					hold_index = *grab_index;
-				}
-				if (grab_index && MouseL.up()) {
-					if (not hold_index) {
-						changeScene(
-							SceneFactory::Create<Result>(*grab_index == target_index),
-							TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-						);
-					}
-					grab_index = hold_index = none;
-				}
-				if (polygon.mouseOver()) {
-					mouseover_index = i;
-					break;
-				}
-			}
-
-			if (hold_index) {
-				shapes[*hold_index].polygon.moveBy(Cursor::PosF() - shapes[*hold_index].polygon.centroid());
-			}
-		}
-		void draw() const override {
-			for (const auto& [polygon, color] : shapes) {
-				polygon.draw(Vec2(3, 3), ColorF(Palette::Lightblue, 0.5));
-				polygon.draw(color);
-			}
-			if (mouseover_index) {
-				shapes[*mouseover_index].polygon.drawFrame(3, Palette::Yellow);
-				//Print << (*mouseover_index == target_index);
-			}
-		}
-	};
-	class Result :public Yeah::Scenes::IScene {
-		const Font font{ 100 };
-		const bool success_ = false;
-	public:
-		Result() {}
-		Result(bool success) :
-			success_(success) {}
-		void update() override {
-			if (SimpleGUI::ButtonAt(U"答え", { 400,400 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Answer>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"戻る", { 400,450 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Title>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-		}
-		void draw() const override {
-			font(success_ ? U"クリア！！！" : U"残念！").drawAt({ 400,180 });
-		}
-	};
-	class Answer :public Yeah::Scenes::IScene {
-		SaturatedLinework<Circle> linework_{ Circle(shapes[target_index].polygon.centroid(),100) };
-		mutable std::function<void()> delay;
-	public:
-		void update() override {
-			if (delay) {
-				delay();
-				delay = decltype(delay)();
-			}
-
-			linework_.generate();
-		}
-		void draw() const override {
-			for (const auto& [polygon, color] : shapes) {
-				polygon.draw(Vec2(3, 3), ColorF(Palette::Lightblue, 0.5));
-				polygon.draw(color);
-			}
-			shapes[target_index].polygon.drawFrame(5, Palette::Yellow);
-			linework_.draw();
-
-			if (SimpleGUI::Button(U"戻る", { 0,0 }, 70)) {
-				delay = [this]() mutable {
-					const_cast<Answer*>(this)->undo(TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s));
-				};
-			}
-		}
-	};
-}
-namespace TenSecondsTimer {
-	class Title :public Yeah::Scenes::IScene {
-		const Font font{ 100 };
-		const std::array<Texture, 12> clocks = {
-			Texture{Emoji(U"🕛")},
-			Texture{Emoji(U"🕐")},
-			Texture{Emoji(U"🕑")},
-			Texture{Emoji(U"🕒")},
-			Texture{Emoji(U"🕓")},
-			Texture{Emoji(U"🕔")},
-			Texture{Emoji(U"🕕")},
-			Texture{Emoji(U"🕖")},
-			Texture{Emoji(U"🕗")},
-			Texture{Emoji(U"🕘")},
-			Texture{Emoji(U"🕙")},
-			Texture{Emoji(U"🕚")},
-		};
-	public:
-		void update() override {
-			if (SimpleGUI::ButtonAt(U"スタート", { 400,350 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Game>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"ルール", { 400,400 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Rule>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"戻る", { 400,450 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Second::Title>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-		}
-		void draw() const override {
-			clocks[static_cast<int32>(Scene::Time()) % clocks.size()].scaled(3).drawAt({ 400,300 }, ColorF(1.0, 0.1));
-			font(U"10秒タイマー").drawAt({ 400,180 });
-		}
-	};
-	class Rule :public Yeah::Scenes::IScene {
-		const Font font{ 100 }, font50{ 50 };
-		const std::array<Texture, 12> clocks = {
-			Texture{Emoji(U"🕛")},
-			Texture{Emoji(U"🕐")},
-			Texture{Emoji(U"🕑")},
-			Texture{Emoji(U"🕒")},
-			Texture{Emoji(U"🕓")},
-			Texture{Emoji(U"🕔")},
-			Texture{Emoji(U"🕕")},
-			Texture{Emoji(U"🕖")},
-			Texture{Emoji(U"🕗")},
-			Texture{Emoji(U"🕘")},
-			Texture{Emoji(U"🕙")},
-			Texture{Emoji(U"🕚")},
-		};
-	public:
-		void update() override {
-			if (SimpleGUI::ButtonAt(U"戻る", { 400,500 }, 200)) {
-				undo(TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s));
-			}
-		}
-		void draw() const override {
-			clocks[static_cast<int32>(Scene::Time()) % clocks.size()].scaled(3).drawAt({ 400,300 }, ColorF(1.0, 0.1));
-			font(U"ルール").drawAt({ 400,120 });
-			font50(U"カウントダウン後にタイマーが\nスタートする\n10秒経ったらボタンを押そう").drawAt({ 400,320 });
-		}
-	};
-	class Game :public Yeah::Scenes::IScene {
-		const Font font{ 100 };
-		const std::array<Texture, 12> clocks = {
-			Texture{Emoji(U"🕛")},
-			Texture{Emoji(U"🕐")},
-			Texture{Emoji(U"🕑")},
-			Texture{Emoji(U"🕒")},
-			Texture{Emoji(U"🕓")},
-			Texture{Emoji(U"🕔")},
-			Texture{Emoji(U"🕕")},
-			Texture{Emoji(U"🕖")},
-			Texture{Emoji(U"🕗")},
-			Texture{Emoji(U"🕘")},
-			Texture{Emoji(U"🕙")},
-			Texture{Emoji(U"🕚")},
-		};
-		enum class State {
-			Wait,
-			CountDown,
-			Time,
-			Finish,
-			Size,
-		} state = State::Wait;
-		Timer count_down_{ 3s };
-		Stopwatch result_;
-	public:
-		void update() override {
-			switch (state) {
-			case State::Wait:
-				if (SimpleGUI::ButtonAt(U"準備OK！", { 400,300 }, 200)) {
-					state = State::CountDown;
-					count_down_.start();
-				}
-				break;
-			case State::CountDown:
-				if (count_down_.reachedZero()) {
-					state = State::Time;
-					result_.start();
-				}
-				break;
-			case State::Time:
-			case State::Finish:
-				if (SimpleGUI::ButtonAt(U"ストップ！", { 400,300 }, 200)) {
-					state = State::Finish;
-					changeScene(
-						SceneFactory::Create<Result>(result_.elapsed()),
-						TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-					);
-				}
-				break;
-			}
-		}
-		void draw() const override {
-			switch (state) {
-			case State::Wait:
-				clocks[static_cast<int32>(Scene::Time()) % clocks.size()].scaled(3).drawAt({ 400,300 }, ColorF(1.0, 0.1));
-				break;
-			case State::CountDown:
-				font(Ceil(count_down_.remaining().count())).drawAt({ 400,300 });
-				break;
-			}
-		}
-	};
-	class Result :public Yeah::Scenes::IScene {
-		const Font font{ 100 }, font50{ 50 };
-		Duration duration_;
-	public:
-		Result(const Duration& duration) :
-			duration_(duration) {}
-		void update() override {
-			if (SimpleGUI::ButtonAt(U"もう一度", { 400,450 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Game>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-			if (SimpleGUI::ButtonAt(U"戻る", { 400,500 }, 200)) {
-				changeScene(
-					SceneFactory::Create<Title>(),
-					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
-				);
-			}
-		}
-		void draw() const override {
-			font(duration_).drawAt({ 400,250 }, Palette::White);
-			font50(Abs((duration_ - 10s).count()) <= 0.5 ? U"お見事！" : U"もう一度！").drawAt({ 400,350 }, Palette::White);
-		}
-	};
-}
-
-/*各ファクトリの定義*/
-template<typename T, typename...Args>
-std::unique_ptr<Yeah::Scenes::IScene> SceneFactory::Create(Args&&...args) {
-	return std::make_unique<T>(std::forward<Args>(args)...);
-}
-template<typename T, typename...Args>
-std::unique_ptr<Yeah::Transitions::ITransition> TransitionFactory::Create(Args&&...args) {
-	return std::make_unique<T>(std::forward<Args>(args)...);
-}
-
-void Main() {
-	Profiler::EnableAssetCreationWarning(false);
-
-	Window::SetTitle(U"MiniGames");
-	Window::SetPos({ 1000,200 });
-	Scene::SetBackground(ColorF(0.2, 0.3, 0.4));
-
-	Yeah::SceneChanger sc(
-		SceneFactory::Create<Master::Title>(),
-		TransitionFactory::Create<Yeah::Transitions::AlphaFadeIn>(1s)
-	);
-	while (System::Update()) {
-		if (not sc.update()) {
-			break;
-		}
-		sc.draw();
-	}
-}
+
+#include<Siv3D.hpp>
+#include<HamFramework.hpp>
+#include"ReactionStats.hpp"
+#if SIV3D_PLATFORM(WINDOWS)
+#include<Siv3D/Windows/Windows.hpp>
+#include<timeapi.h>
+#pragma comment(lib, "winmm")
+#endif
+
+namespace Yeah {
+	namespace Scenes { class IScene; }
+	namespace Transitions { class ITransition; }
+	class SceneChanger;
+}
+
+namespace Yeah {
+	namespace Memory {
+		//GPU側の大きさの見積もり(RGBA8)
+		inline size_t Estimate(const Texture& texture) {
+			return static_cast<size_t>(texture.width()) * texture.height() * 4;
+		}
+		template<typename T>
+		size_t Estimate(const Grid<T>& grid) {
+			return grid.num_elements() * sizeof(T);
+		}
+
+		//確保の付け先。グローバルなoperator newがそのスレッドで有効な勘定に付け、解放時に同じ勘定から引く
+		//グローバルなoperator newを差し替えるのはMINIGAMES_TRACK_ALLOCATIONSを定義したビルドだけ。それ以外では勘定は空のまま
+		enum class Phase : uint8 { Other, Update, Draw, Simulate };
+		constexpr size_t PhaseCount = 4;
+
+		class Account {
+			const char* name_;
+			std::atomic<int64> live_bytes_{ 0 }, live_count_{ 0 }, peak_bytes_{ 0 };
+			std::atomic<uint64> allocations_{ 0 };
+			friend class Ledger;
+		public:
+			constexpr explicit Account(const char* name) :
+				name_(name) {}
+
+			void add(size_t size) {
+				const int64 live = live_bytes_ += static_cast<int64>(size);
+				++live_count_;
+				++allocations_;
+				for (int64 peak = peak_bytes_; peak < live && not peak_bytes_.compare_exchange_weak(peak, live);) {}
+			}
+			void remove(size_t size) {
+				live_bytes_ -= static_cast<int64>(size);
+				--live_count_;
+			}
+			const char* name() const { return name_; }
+			int64 liveBytes() const { return live_bytes_; }
+			int64 liveCount() const { return live_count_; }
+			int64 peakBytes() const { return peak_bytes_; }
+			uint64 allocations() const { return allocations_; }
+		};
+		//どこにも付けないもの(SceneChanger自身、アロケータの補充など)
+		inline Account& Unattributed() {
+			static Account account{ "other" };
+			return account;
+		}
+		//シーンをまたいで共有するもの(アセットのキャッシュ)
+		inline Account& Shared() {
+			static Account account{ "shared" };
+			return account;
+		}
+		inline Account& TransitionAccount() {
+			static Account account{ "transition" };
+			return account;
+		}
+
+		namespace Tracking {
+#ifdef MINIGAMES_TRACK_ALLOCATIONS
+			inline constexpr bool Enabled = true;
+#else
+			inline constexpr bool Enabled = false;
+#endif
+			inline thread_local Account* current = nullptr;
+			inline thread_local Phase phase = Phase::Other;
+			inline std::atomic<uint64> allocations[PhaseCount] = {};
+
+			struct alignas(16) Block {	//確保した領域の前に置く
+				Account* account;
+				size_t size;
+			};
+			inline void* Allocate(size_t size) {
+				void* base = std::malloc(sizeof(Block) + size);
+				if (not base) {
+					return nullptr;
+				}
+				Account* account = current ? current : &Unattributed();
+				::new(base) Block{ account, size };
+				account->add(size);
+				++allocations[static_cast<size_t>(phase)];
+				return static_cast<Block*>(base) + 1;
+			}
+			inline void Free(void* p) {
+				if (not p) {
+					return;
+				}
+				Block* block = static_cast<Block*>(p) - 1;
+				block->account->remove(block->size);
+				std::free(block);
+			}
+		}
+
+		//スコープの間の確保をaccountに付ける(nullptrなら今のまま)
+		class Charge {
+			Account* previous_;
+		public:
+			explicit Charge(Account* account) :
+				previous_(Tracking::current) {
+				if (account) {
+					Tracking::current = account;
+				}
+			}
+			explicit Charge(Account& account) :
+				Charge(&account) {}
+			~Charge() {
+				Tracking::current = previous_;
+			}
+			Charge(const Charge&) = delete;
+			Charge& operator=(const Charge&) = delete;
+		};
+		class During {
+			Phase previous_;
+		public:
+			explicit During(Phase phase) :
+				previous_(Tracking::phase) {
+				Tracking::phase = phase;
+			}
+			~During() {
+				Tracking::phase = previous_;
+			}
+			During(const During&) = delete;
+			During& operator=(const During&) = delete;
+		};
+
+		//シーンごとの勘定。閉じた後も確保が残っていればリークとして報告し、空になったら使い回す
+		class Ledger {
+			static constexpr uint64 GraceFrames = 120;	//ワーカーやアセットの遅れた解放を待つ
+			struct Closed {
+				Account* account;
+				uint64 frame;
+			};
+			std::mutex mutex_;
+			Array<std::unique_ptr<Account>> accounts_;
+			Array<Account*> free_;
+			Array<Closed> closed_;
+			uint64 frame_ = 0;
+			std::array<uint64, PhaseCount> last_{}, per_frame_{};
+		public:
+			Account* open(const char* name) {
+				const Charge charge{ Unattributed() };
+				std::lock_guard lock(mutex_);
+				if (free_.isEmpty()) {
+					accounts_ << std::make_unique<Account>(name);
+					return accounts_.back().get();
+				}
+				Account* account = free_.back();
+				free_.pop_back();
+				account->name_ = name;
+				account->peak_bytes_ = 0;
+				account->allocations_ = 0;
+				return account;
+			}
+			void close(Account* account) {
+				const Charge charge{ Unattributed() };
+				std::lock_guard lock(mutex_);
+				closed_ << Closed{ account, frame_ };
+			}
+
+			//メインスレッドで毎フレーム呼ぶ
+			void endFrame() {
+				const Charge charge{ Unattributed() };
+				std::lock_guard lock(mutex_);
+				++frame_;
+				for (size_t i = 0; i < PhaseCount; ++i) {
+					const uint64 total = Tracking::allocations[i];
+					per_frame_[i] = total - last_[i];
+					last_[i] = total;
+				}
+				closed_.remove_if([this](const Closed& c) {
+					if (c.account->liveCount() != 0) {
+						return false;
+					}
+					free_ << c.account;	//残りがないので、もう誰もこの勘定を指していない
+					return true;
+				});
+			}
+			//直前のフレームのフェーズごとの確保回数
+			std::array<uint64, PhaseCount> allocationsPerFrame() {
+				std::lock_guard lock(mutex_);
+				return per_frame_;
+			}
+			//閉じてからGraceFrames経っても確保が残っている勘定
+			Array<std::pair<String, int64>> leaks() {
+				const Charge charge{ Unattributed() };
+				std::lock_guard lock(mutex_);
+				Array<std::pair<String, int64>> result;
+				for (const auto& c : closed_) {
+					if (frame_ - c.frame >= GraceFrames) {
+						result.emplace_back(Unicode::Widen(c.account->name()), c.account->liveBytes());
+					}
+				}
+				return result;
+			}
+		};
+		inline Ledger& GetLedger() {
+			static Ledger& ledger = *new Ledger;	//静的オブジェクトの破棄が全部済むまで残す
+			return ledger;
+		}
+
+		struct Stats {
+			std::atomic<uint64> allocations{ 0 };	//アロケータ経由の確保
+			std::atomic<uint64> heap_allocations{ 0 };	//そのうちヒープまで行ったもの(プールの補充も含む)
+		};
+		inline Stats& GetStats() {
+			static Stats stats;
+			return stats;
+		}
+
+		//シーン・遷移オブジェクト用のアロケータ。tagはアロケータが解放時に使う任意の値
+		class IAllocator {
+		public:
+			virtual ~IAllocator() = default;
+			virtual void* allocate(size_t size, void*& tag) = 0;
+			virtual void deallocate(void* p, size_t size, void* tag) = 0;
+		};
+
+		class HeapAllocator :public IAllocator {
+		public:
+			void* allocate(size_t size, void*& tag) override {
+				tag = nullptr;
+				++GetStats().heap_allocations;
+				return ::operator new(size);
+			}
+			void deallocate(void* p, [[maybe_unused]] size_t size, [[maybe_unused]] void* tag) override {
+				::operator delete(p);
+			}
+		};
+		inline HeapAllocator& Heap() {
+			static HeapAllocator heap;
+			return heap;
+		}
+
+		//2の累乗のサイズクラスごとのフリーリスト。シーンはワーカースレッドでも作られるのでロックする
+		class PoolAllocator :public IAllocator {
+			static constexpr size_t MinClass = 6, MaxClass = 13;	//64B〜8KB
+			static constexpr size_t BlocksPerSlab = 16;
+
+			std::mutex mutex_;
+			std::array<void*, MaxClass - MinClass + 1> free_{};
+			Array<std::unique_ptr<std::byte[]>> slabs_;
+		public:
+			void* allocate(size_t size, void*& tag) override {
+				const size_t c = sizeClass(size);
+				if (c > MaxClass) {
+					return Heap().allocate(size, tag);
+				}
+				tag = this;
+
+				std::lock_guard lock(mutex_);
+				void*& head = free_[c - MinClass];
+				if (not head) {
+					refill(c);
+				}
+				void* p = head;
+				head = *static_cast<void**>(p);
+				return p;
+			}
+			void deallocate(void* p, size_t size, void* tag) override {
+				if (tag != this) {
+					Heap().deallocate(p, size, tag);
+					return;
+				}
+				std::lock_guard lock(mutex_);
+				void*& head = free_[sizeClass(size) - MinClass];
+				*static_cast<void**>(p) = head;
+				head = p;
+			}
+
+		private:
+			static size_t sizeClass(size_t size) {
+				size_t c = MinClass;
+				while ((size_t{ 1 } << c) < size) {
+					++c;
+				}
+				return c;
+			}
+			void refill(size_t c) {
+				const size_t block = size_t{ 1 } << c;
+				++GetStats().heap_allocations;
+				const Charge charge{ Unattributed() };	//スラブは使い回すのでシーンには付けない
+				slabs_ << std::make_unique<std::byte[]>(block * BlocksPerSlab);
+				std::byte* slab = slabs_.back().get();
+				void*& head = free_[c - MinClass];
+				for (size_t i = 0; i < BlocksPerSlab; ++i) {
+					void* p = slab + block * i;
+					*static_cast<void**>(p) = head;
+					head = p;
+				}
+			}
+		};
+
+		//前から詰めていくだけのアリーナ。チャンク内のオブジェクトが全部解放されたらチャンクごと使い回す
+		class ArenaAllocator :public IAllocator {
+			static constexpr size_t ChunkSize = 16 << 10;
+			static constexpr size_t Align = 16;
+			struct Chunk {
+				std::unique_ptr<std::byte[]> memory = std::make_unique<std::byte[]>(ChunkSize);
+				size_t used = 0;
+				size_t live = 0;
+			};
+
+			std::mutex mutex_;
+			Array<std::unique_ptr<Chunk>> chunks_;
+			Array<Chunk*> spare_;
+			Chunk* current_ = nullptr;
+		public:
+			void* allocate(size_t size, void*& tag) override {
+				const size_t need = (size + Align - 1) / Align * Align;
+				if (need > ChunkSize) {
+					return Heap().allocate(size, tag);
+				}
+
+				std::lock_guard lock(mutex_);
+				if (not current_ || ChunkSize < current_->used + need) {
+					retire(current_);
+					current_ = nextChunk();
+				}
+				void* p = current_->memory.get() + current_->used;
+				current_->used += need;
+				++current_->live;
+				tag = current_;
+				return p;
+			}
+			void deallocate(void* p, size_t size, void* tag) override {
+				if (not tag) {
+					Heap().deallocate(p, size, tag);
+					return;
+				}
+				std::lock_guard lock(mutex_);
+				Chunk* chunk = static_cast<Chunk*>(tag);
+				--chunk->live;
+				if (chunk != current_) {
+					retire(chunk);
+				}
+			}
+
+		private:
+			void retire(Chunk* chunk) {
+				if (chunk && chunk->live == 0) {
+					chunk->used = 0;
+					spare_ << chunk;
+				}
+			}
+			Chunk* nextChunk() {
+				if (not spare_.empty()) {
+					Chunk* chunk = spare_.back();
+					spare_.pop_back();
+					return chunk;
+				}
+				++GetStats().heap_allocations;
+				const Charge charge{ Unattributed() };
+				chunks_ << std::make_unique<Chunk>();
+				return chunks_.back().get();
+			}
+		};
+
+		//確保したアロケータを先頭に書いておき、解放時にそこへ返す
+		struct Header {
+			IAllocator* allocator;
+			void* tag;
+		};
+		constexpr size_t HeaderSize = 16;	//中身の16バイトアラインを崩さない
+		static_assert(sizeof(Header) <= HeaderSize);
+		inline void* Allocate(IAllocator& allocator, size_t size) {
+			++GetStats().allocations;
+			void* tag = nullptr;
+			void* p = allocator.allocate(HeaderSize + size, tag);
+			*static_cast<Header*>(p) = Header{ &allocator, tag };
+			return static_cast<std::byte*>(p) + HeaderSize;
+		}
+		inline void Deallocate(void* p, size_t size) {
+			if (not p) { return; }
+			void* base = static_cast<std::byte*>(p) - HeaderSize;
+			const Header header = *static_cast<Header*>(base);
+			header.allocator->deallocate(base, HeaderSize + size, header.tag);
+		}
+	}
+}
+
+#ifdef MINIGAMES_TRACK_ALLOCATIONS
+//確保をすべて勘定に付ける。new[]・nothrow・サイズつきdeleteの既定の実装はここに来る
+//確保ごとに16バイトの頭と共有の勘定への原子的な更新が増えるので、計測用のビルドだけで使う
+void* operator new(size_t size) {
+	for (;;) {
+		if (void* p = Yeah::Memory::Tracking::Allocate(size)) {
+			return p;
+		}
+		if (auto handler = std::get_new_handler()) {
+			handler();
+		}
+		else {
+			throw std::bad_alloc{};
+		}
+	}
+}
+void operator delete(void* p) noexcept {
+	Yeah::Memory::Tracking::Free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+	Yeah::Memory::Tracking::Free(p);
+}
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+void operator delete[](void* p) noexcept {
+	Yeah::Memory::Tracking::Free(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+	Yeah::Memory::Tracking::Free(p);
+}
+#endif
+
+namespace Yeah {
+	//フレーム内のどこで時間を使っているかの計測。無効のときはScopeがフラグを一度読むだけ
+	namespace Profiler {
+		struct Event {
+			const char* name;
+			const char* detail;	//シーン・遷移の型名(なければnullptr)
+			uint64 begin, end;	//ns
+		};
+
+		//スレッドごとのリングバッファ。書くのは持ち主のスレッドだけ、読むのはメインスレッドだけなのでロックしない
+		class Ring {
+			static constexpr size_t Capacity = 4096;
+			std::array<Event, Capacity> events_;
+			std::atomic<size_t> head_{ 0 }, tail_{ 0 };
+		public:
+			const uint32 thread_id;
+			std::atomic<bool> retired{ false };	//スレッドが終わった。読み切ったら捨てる
+
+			explicit Ring(uint32 thread_id) :
+				thread_id(thread_id) {}
+			void push(const Event& event) {
+				const size_t head = head_.load(std::memory_order_relaxed);
+				if (head - tail_.load(std::memory_order_acquire) >= Capacity) {
+					return;	//読む側が追いついていなければ捨てる
+				}
+				events_[head % Capacity] = event;
+				head_.store(head + 1, std::memory_order_release);
+			}
+			template<typename F>
+			void drain(F&& f) {
+				const size_t head = head_.load(std::memory_order_acquire);
+				size_t tail = tail_.load(std::memory_order_relaxed);
+				for (; tail != head; ++tail) {
+					f(events_[tail % Capacity]);
+				}
+				tail_.store(tail, std::memory_order_release);
+			}
+		};
+
+		struct State {
+			std::atomic<bool> enabled{ false };
+			std::mutex mutex;	//リングの登録と削除だけ
+			Array<std::unique_ptr<Ring>> rings;
+			uint32 next_thread_id = 0;
+		};
+		inline State& GetState() {
+			static State state;
+			return state;
+		}
+		inline bool IsEnabled() {
+			return GetState().enabled.load(std::memory_order_relaxed);
+		}
+		inline void SetEnabled(bool enabled) {
+			GetState().enabled = enabled;
+		}
+		inline Ring& LocalRing() {
+			struct Holder {
+				Ring* ring;
+				Holder() {
+					auto& state = GetState();
+					std::lock_guard lock(state.mutex);
+					state.rings << std::make_unique<Ring>(state.next_thread_id++);
+					ring = state.rings.back().get();
+				}
+				~Holder() {
+					ring->retired = true;
+				}
+			};
+			thread_local Holder holder;
+			return *holder.ring;
+		}
+
+		class Scope {
+			const char* name_;
+			const char* detail_;
+			uint64 begin_ = 0;
+			const bool active_;
+		public:
+			Scope(const char* name, const char* detail = nullptr) :
+				name_(name),
+				detail_(detail),
+				active_(IsEnabled()) {
+				if (active_) {
+					begin_ = Time::GetNanosec();
+				}
+			}
+			template<typename T, std::enable_if_t<std::is_polymorphic_v<T>>* = nullptr>
+			Scope(const char* name, const T& object) :
+				Scope(name, typeid(object).name()) {}
+			~Scope() {
+				if (active_) {
+					LocalRing().push(Event{ name_, detail_, begin_, Time::GetNanosec() });
+				}
+			}
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		};
+
+		//メインスレッドで毎フレーム各スレッドのリングを読み出して、スコープごとのヒストグラムとトレースにまとめる
+		class Report {
+		public:
+			static constexpr size_t BinCount = 34;
+			static constexpr double BinWidth = 0.5;	//ms
+			static constexpr size_t Window = 240;	//ヒストグラムに使う直近の回数
+			static constexpr size_t MaxTraceEvents = 1 << 20;
+
+		private:
+			struct Series {
+				String label;
+				Array<double> samples;	//ms。Window個で一周する
+				size_t next = 0;
+				double max = 0.0;
+			};
+			struct KeyHash {
+				size_t operator()(const std::pair<const char*, const char*>& key) const {
+					return std::hash<const void*>{}(key.first) ^ (std::hash<const void*>{}(key.second) * 31);
+				}
+			};
+			HashTable<std::pair<const char*, const char*>, Series, KeyHash> series_;
+			Array<std::pair<uint32, Event>> trace_;
+			Optional<uint64> origin_;
+		public:
+			void collect() {
+				auto& state = GetState();
+				std::lock_guard lock(state.mutex);
+				for (auto& ring : state.rings) {
+					ring->drain([&](const Event& event) { add(ring->thread_id, event); });
+				}
+				state.rings.remove_if([](const std::unique_ptr<Ring>& ring) { return ring->retired.load(); });
+			}
+			void clear() {
+				series_.clear();
+				trace_.clear();
+				origin_.reset();
+			}
+
+			void draw(const Font& font, const Vec2& pos) const {
+				Array<const Series*> sorted;
+				for (const auto& [key, series] : series_) {
+					sorted << &series;
+				}
+				sorted.sort_by([](const Series* a, const Series* b) { return a->label < b->label; });
+
+				constexpr double RowHeight = 20, BinSize = 3;
+				for (const auto& [i, series] : Indexed(sorted)) {
+					const Vec2 row = pos + Vec2(0, RowHeight * i);
+					std::array<size_t, BinCount> bins{};
+					double sum = 0.0;
+					for (const double ms : series->samples) {
+						++bins[Min(static_cast<size_t>(ms / BinWidth), BinCount - 1)];
+						sum += ms;
+					}
+					const size_t peak = *std::max_element(bins.begin(), bins.end());
+					for (size_t b = 0; b < BinCount; ++b) {
+						const double h = peak ? (RowHeight - 4) * bins[b] / peak : 0.0;
+						RectF(Arg::bottomLeft = row + Vec2(BinSize * b, RowHeight - 2), BinSize - 1, h).draw(b + 1 == BinCount ? Palette::Orangered : Palette::Skyblue);
+					}
+					font(U"{} avg {:.2f} max {:.2f} ms"_fmt(series->label, sum / Max<size_t>(series->samples.size(), 1), series->max))
+						.draw(row + Vec2(BinSize * BinCount + 8, 0), Palette::White);
+				}
+			}
+
+			//chrome://tracing や Perfetto で開ける形式で書き出す
+			bool exportChromeTrace(FilePathView path) const {
+				TextWriter writer{ path };
+				if (not writer) {
+					return false;
+				}
+				writer.writeln(U"{\"traceEvents\":[");
+				for (const auto& [i, e] : Indexed(trace_)) {
+					const auto& [thread, event] = e;
+					writer.writeln(U"{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":0,\"tid\":{}}}{}"_fmt(
+						Unicode::Widen(event.detail ? event.detail : event.name),
+						Unicode::Widen(event.name),
+						(event.begin - *origin_) / 1000.0,
+						(event.end - event.begin) / 1000.0,
+						thread,
+						i + 1 < trace_.size() ? U"," : U""));
+				}
+				writer.writeln(U"]}");
+				return true;
+			}
+
+		private:
+			void add(uint32 thread, const Event& event) {
+				if (not origin_) {
+					origin_ = event.begin;
+				}
+				if (trace_.size() < MaxTraceEvents && *origin_ <= event.begin) {
+					trace_.emplace_back(thread, event);
+				}
+
+				auto [it, inserted] = series_.try_emplace({ event.name, event.detail });
+				auto& series = it->second;
+				if (inserted) {
+					series.label = event.detail ? U"{} {}"_fmt(Unicode::Widen(event.detail), Unicode::Widen(event.name)) : Unicode::Widen(event.name);
+					series.samples.reserve(Window);
+				}
+				const double ms = (event.end - event.begin) / 1e6;
+				if (series.samples.size() < Window) {
+					series.samples << ms;
+				}
+				else {
+					series.samples[series.next] = ms;
+				}
+				series.next = (series.next + 1) % Window;
+				series.max = Max(series.max, ms);
+			}
+		};
+	}
+}
+
+namespace Yeah {
+	//ゲームが読む入力と時間。毎フレームISourceから一度だけ取り込むので、ライブでもスクリプトでも同じに見える
+	namespace Inputs {
+		//ゲームが読むキー。ビット1から順に割り当てる(ビット0は左クリック)
+		inline const Array<s3d::Input>& TrackedKeys() {
+			static const Array<s3d::Input> keys{ KeyB, MouseR };
+			return keys;
+		}
+		inline Optional<size_t> FindTrackedKey(const std::function<bool(const s3d::Input&)>& pred) {
+			for (const auto& [i, key] : Indexed(TrackedKeys())) {
+				if (pred(key)) {
+					return i;
+				}
+			}
+			return none;
+		}
+
+		struct Frame {
+			Vec2 cursor{ 0, 0 };
+			uint32 buttons = 0;
+			uint32 press_lead = 0;	//左クリックが実際に押されてからこのフレームで取り込むまで(μs)。わからなければ0
+			double delta_time = 0.0;	//実際に進めた秒数(マイクロ秒単位)
+			uint32 polls = 0;	//このフレームで非同期処理の完了を問い合わせた結果。1回目から順に1ビットずつ
+			uint32 checkpoint = 0;	//フレームを終えたときの状態のハッシュ(再生時は記録の値)
+		};
+
+		class ISource {
+		public:
+			virtual ~ISource() = default;
+			virtual Optional<Frame> next() = 0;	//noneで入力の終わり
+			virtual void endFrame([[maybe_unused]] const Frame& frame, [[maybe_unused]] uint32 checkpoint) {}
+			virtual bool replaying() const { return false; }	//pollsを記録どおりに返す
+			virtual void setPressTiming([[maybe_unused]] bool enabled) {}	//押した時刻を細かく見るか(見るのはライブの入力だけ)
+		};
+
+		//OSのボタンの状態を1msごとに見て、押された時刻を残す。Siv3Dの入力はフレーム単位でしか更新されないので別に見る
+		//setEnabledしている間だけ動かす(タイマーの分解能もその間だけ上げる)。ウィンドウが前面でカーソルが中にあるときの押下だけ数える
+		//Windows以外では何もせず、押した時刻はフレームで取り込んだ時刻になる
+		class PressSampler {
+			std::atomic<uint64> pressed_at_{ 0 };
+			std::atomic<bool> running_{ false };
+			std::thread thread_;
+		public:
+			PressSampler() = default;
+			~PressSampler() {
+				setEnabled(false);
+			}
+			void setEnabled(bool enabled) {
+				if (enabled == running_) {
+					return;
+				}
+				running_ = enabled;
+				if (not enabled) {
+					if (thread_.joinable()) {
+						thread_.join();
+					}
+					return;
+				}
+#if SIV3D_PLATFORM(WINDOWS)
+				const HWND window = static_cast<HWND>(s3d::Platform::Windows::Window::GetHWND());
+				thread_ = std::thread([this, window]() {
+					::timeBeginPeriod(1);
+					bool last = false;
+					while (running_) {
+						//左右を入れ替えていれば主ボタンは右
+						const int32 primary = ::GetSystemMetrics(SM_SWAPBUTTON) ? VK_RBUTTON : VK_LBUTTON;
+						const bool pressed = (::GetAsyncKeyState(primary) & 0x8000) != 0;
+						if (pressed && not last && inside(window)) {
+							pressed_at_ = s3d::Time::GetMicrosec();
+						}
+						last = pressed;
+						std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					}
+					::timeEndPeriod(1);
+				});
+#endif
+			}
+			uint64 pressedAt() const {
+				return pressed_at_;
+			}
+
+		private:
+#if SIV3D_PLATFORM(WINDOWS)
+			static bool inside(HWND window) {
+				POINT cursor{};
+				RECT client{};
+				return ::GetForegroundWindow() == window
+					&& ::GetCursorPos(&cursor) && ::ScreenToClient(window, &cursor) && ::GetClientRect(window, &client)
+					&& ::PtInRect(&client, cursor);
+			}
+#endif
+		};
+
+		class LiveSource :public ISource {
+			Optional<uint64> last_;
+			uint32 last_buttons_ = 0;
+			PressSampler sampler_;
+		public:
+			Optional<Frame> next() override {
+				const uint64 now = s3d::Time::GetMicrosec();
+				Frame frame{ Cursor::PosF(), 0, 0, last_ ? (now - *last_) / 1e6 : 0.0 };
+				last_ = now;
+				if (s3d::MouseL.pressed()) {
+					frame.buttons |= 1;
+					const uint64 at = sampler_.pressedAt();
+					if (not (last_buttons_ & 1) && at && at <= now && now - at < 100'000) {	//古い記録は別の押下
+						frame.press_lead = static_cast<uint32>(now - at);
+					}
+				}
+				for (const auto& [i, key] : Indexed(TrackedKeys())) {
+					if (key.pressed()) {
+						frame.buttons |= 1u << (i + 1);
+					}
+				}
+				last_buttons_ = frame.buttons;
+				return frame;
+			}
+			void setPressTiming(bool enabled) override {
+				sampler_.setEnabled(enabled);
+			}
+		};
+
+		//テキストの台本から固定刻みのフレームを作る。1行1命令、#以降はコメント
+		//  wait N / move X Y / click X Y / press / release / key NAME / expect シーン名の一部
+		class ScriptSource :public ISource {
+			struct Step {
+				Frame frame;
+				Array<String> expect;	//このフレームを更新した後に今のシーンであるべきもの
+			};
+			Array<Step> steps_;
+			size_t next_ = 0;
+		public:
+			ScriptSource(FilePathView path, double deltaTime = 1.0 / 60) {
+				TextReader reader{ path };
+				if (not reader) {
+					throw Error{ U"ScriptSource: cannot open {}"_fmt(path) };
+				}
+				Frame frame;
+				frame.delta_time = deltaTime;
+				const auto emit = [&](int32 count) {
+					for (int32 i = 0; i < count; ++i) {
+						steps_ << Step{ frame };
+					}
+				};
+				String line;
+				while (reader.readLine(line)) {
+					const auto args = line.substr(0, line.indexOf(U'#')).replaced(U'\t', U' ').split(U' ').removed_if([](const String& a) { return a.isEmpty(); });
+					if (args.isEmpty()) {
+						continue;
+					}
+					const String& op = args[0];
+					if (op == U"wait") {
+						emit(args.size() > 1 ? Parse<int32>(args[1]) : 1);
+					}
+					else if (op == U"move" || op == U"click") {
+						frame.cursor = Vec2(Parse<double>(args.at(1)), Parse<double>(args.at(2)));
+						if (op == U"click") {
+							frame.buttons |= 1;
+							emit(1);
+							frame.buttons &= ~1u;
+							emit(1);
+						}
+					}
+					else if (op == U"press") {
+						frame.buttons |= 1;
+					}
+					else if (op == U"release") {
+						frame.buttons &= ~1u;
+					}
+					else if (op == U"key") {
+						const auto key = FindTrackedKey([&](const s3d::Input& k) { return k.name() == args.at(1); });
+						if (not key) {
+							throw Error{ U"ScriptSource: unknown key {}"_fmt(args[1]) };
+						}
+						const uint32 bit = 1u << (*key + 1);
+						frame.buttons |= bit;
+						emit(1);
+						frame.buttons &= ~bit;
+					}
+					else if (op == U"expect") {
+						if (steps_.isEmpty()) {
+							emit(1);
+						}
+						steps_.back().expect << args.at(1);
+					}
+					else {
+						throw Error{ U"ScriptSource: unknown command {}"_fmt(op) };
+					}
+				}
+			}
+			Optional<Frame> next() override {
+				if (next_ >= steps_.size()) {
+					return none;
+				}
+				return steps_[next_++].frame;
+			}
+			//直前にnextで返したフレームの確認事項
+			const Array<String>& expectations() const {
+				static const Array<String> empty;
+				return next_ ? steps_[next_ - 1].expect : empty;
+			}
+		};
+
+		//ライブの入力をそのまま使いながら、毎フレームの入力・経過時間・非同期の完了をバイナリで書き出す
+		//  ヘッダ: "YEAHREC2" 乱数のシード(uint64)
+		//  フレーム: フラグ(uint8) [カーソル(double×2)] [ボタン(uint32)] [press_lead(uint32)] 経過(uint32 μs) [polls(uint32)] checkpoint(uint32)
+		//  フラグは1がカーソル、2がボタン、8がpress_lead、4がpollsを書いたとき。変わっていないものは書かない
+		namespace Log {
+			inline constexpr std::array<char, 8> Magic{ 'Y', 'E', 'A', 'H', 'R', 'E', 'C', '2' };	//2でcheckpointにシーンの状態が入った
+			enum Flag : uint8 {
+				CursorChanged = 1,
+				ButtonsChanged = 2,
+				HasPolls = 4,
+				HasPressLead = 8,
+			};
+		}
+		class RecordingSource :public ISource {
+			LiveSource live_;
+			BinaryWriter writer_;
+			Frame last_;
+		public:
+			RecordingSource(FilePathView path, uint64 seed) :
+				writer_(path) {
+				if (not writer_) {
+					throw Error{ U"RecordingSource: cannot open {}"_fmt(path) };
+				}
+				writer_.write(Log::Magic);
+				writer_.write(seed);
+			}
+			Optional<Frame> next() override {
+				return live_.next();
+			}
+			void setPressTiming(bool enabled) override {
+				live_.setPressTiming(enabled);
+			}
+			void endFrame(const Frame& frame, uint32 checkpoint) override {
+				const uint8 flags = (frame.cursor != last_.cursor ? Log::CursorChanged : 0)
+					| (frame.buttons != last_.buttons ? Log::ButtonsChanged : 0)
+					| (frame.polls ? Log::HasPolls : 0)
+					| (frame.press_lead ? Log::HasPressLead : 0);
+				writer_.write(flags);
+				if (flags & Log::CursorChanged) {
+					writer_.write(frame.cursor.x);
+					writer_.write(frame.cursor.y);
+				}
+				if (flags & Log::ButtonsChanged) {
+					writer_.write(frame.buttons);
+				}
+				if (flags & Log::HasPressLead) {
+					writer_.write(frame.press_lead);
+				}
+				writer_.write(static_cast<uint32>(std::llround(frame.delta_time * 1e6)));
+				if (flags & Log::HasPolls) {
+					writer_.write(frame.polls);
+				}
+				writer_.write(checkpoint);
+				last_ = frame;
+			}
+		};
+		//RecordingSourceの記録を流す。checkpointが食い違ったフレームを数える
+		class ReplaySource :public ISource {
+			BinaryReader reader_;
+			uint64 seed_ = 0;
+			Frame last_;
+			size_t frame_count_ = 0;
+			Array<size_t> diverged_;
+			bool truncated_ = false;
+		public:
+			ReplaySource(FilePathView path) :
+				reader_(path) {
+				std::array<char, 8> magic{};
+				if (not reader_ || not reader_.read(magic) || magic != Log::Magic || not reader_.read(seed_)) {
+					throw Error{ U"ReplaySource: {} is not a recording"_fmt(path) };
+				}
+			}
+			uint64 seed() const {
+				return seed_;
+			}
+			const Array<size_t>& diverged() const {
+				return diverged_;
+			}
+			//最後のフレームが途中で切れていた
+			bool truncated() const {
+				return truncated_;
+			}
+
+			Optional<Frame> next() override {
+				uint8 flags = 0;
+				if (not reader_.read(flags)) {
+					return none;
+				}
+				Frame frame = last_;
+				frame.polls = 0;
+				frame.press_lead = 0;
+				uint32 microsec = 0;
+				const bool complete = (not (flags & Log::CursorChanged) || (reader_.read(frame.cursor.x) && reader_.read(frame.cursor.y)))
+					&& (not (flags & Log::ButtonsChanged) || reader_.read(frame.buttons))
+					&& (not (flags & Log::HasPressLead) || reader_.read(frame.press_lead))
+					&& reader_.read(microsec)
+					&& (not (flags & Log::HasPolls) || reader_.read(frame.polls))
+					&& reader_.read(frame.checkpoint);
+				if (not complete) {
+					truncated_ = true;	//読めたところまでで止める
+					return none;
+				}
+				frame.delta_time = microsec / 1e6;
+				last_ = frame;
+				return frame;
+			}
+			void endFrame(const Frame& frame, uint32 checkpoint) override {
+				if (frame.checkpoint != checkpoint) {
+					diverged_ << frame_count_;
+				}
+				++frame_count_;
+			}
+			bool replaying() const override {
+				return true;
+			}
+		};
+
+		//入力のフレームで進む時計。Timer・Stopwatchに渡して、シーンの時間もスクリプトの時間に合わせる
+		class FrameClock :public ISteadyClock {
+			std::atomic<uint64> microsec_{ 0 };	//Timerはワーカースレッドで作られることもある
+		public:
+			uint64 getMicrosec() override {
+				return microsec_.load();
+			}
+			void advance(double seconds) {
+				microsec_ += static_cast<uint64>(seconds * 1e6);
+			}
+		};
+
+		struct State {
+			std::unique_ptr<ISource> source = std::make_unique<LiveSource>();
+			Frame current, previous;
+			FrameClock clock;
+			std::array<double, 32> pressed_since{};
+			size_t poll_index = 0;
+			bool press_timing = false;	//このフレームでRequestPressTimingされた
+		};
+		inline State& GetState() {
+			static State state;
+			return state;
+		}
+		inline void SetSource(std::unique_ptr<ISource>&& source) {
+			GetState().source = std::move(source);
+		}
+		//フレームの頭で一度呼ぶ。入力が尽きたらfalse
+		inline bool Update() {
+			auto& state = GetState();
+			const auto next = state.source->next();
+			if (not next) {
+				return false;
+			}
+			state.previous = state.current;
+			state.current = *next;
+			state.poll_index = 0;
+			state.clock.advance(next->delta_time);
+			const double now = state.clock.getMicrosec() / 1e6;
+			for (size_t i = 0; i < state.pressed_since.size(); ++i) {
+				if ((state.current.buttons & ~state.previous.buttons) >> i & 1) {
+					state.pressed_since[i] = (i == 0) ? now - state.current.press_lead / 1e6 : now;
+				}
+			}
+			return true;
+		}
+		//フレームの終わりに一度呼ぶ。checkpointは記録と再生の食い違いを見つけるための状態のハッシュ
+		inline void EndFrame(uint32 checkpoint) {
+			auto& state = GetState();
+			state.source->endFrame(state.current, checkpoint);
+			state.source->setPressTiming(std::exchange(state.press_timing, false));
+		}
+		//押した時刻を細かく見たいシーンがupdateで毎フレーム呼ぶ。呼ばれなくなったフレームで止まる
+		inline void RequestPressTiming() {
+			GetState().press_timing = true;
+		}
+
+		//非同期処理の完了の問い合わせ。終わるタイミングは実行ごとに違うので、結果を記録して再生時はそれに合わせて待つ
+		template<typename T>
+		bool Ready(const AsyncTask<T>& task) {
+			auto& state = GetState();
+			const uint32 bit = 1u << Min<size_t>(state.poll_index++, 31);
+			if (state.source->replaying()) {
+				if (not (state.current.polls & bit)) {
+					return false;
+				}
+				task.wait();
+				return true;
+			}
+			const bool ready = task.isReady();
+			if (ready) {
+				state.current.polls |= bit;
+			}
+			return ready;
+		}
+
+		inline ISteadyClock* Clock() {
+			return &GetState().clock;
+		}
+		inline double Time() {
+			return GetState().clock.getMicrosec() / 1e6;
+		}
+		//Scene::DeltaTimeと同じく0.1秒で頭打ち
+		inline double DeltaTime() {
+			return Min(GetState().current.delta_time, 0.1);
+		}
+		inline Vec2 CursorPos() {
+			return GetState().current.cursor;
+		}
+
+		struct Button {
+			uint32 bit;
+			bool down() const {
+				const auto& state = GetState();
+				return (state.current.buttons & bit) && not (state.previous.buttons & bit);
+			}
+			bool pressed() const {
+				return GetState().current.buttons & bit;
+			}
+			bool up() const {
+				const auto& state = GetState();
+				return not (state.current.buttons & bit) && (state.previous.buttons & bit);
+			}
+			//押された時刻(Time()と同じ時計)。左クリックはフレームより細かい
+			double pressedAt() const {
+				return GetState().pressed_since[std::countr_zero(bit)];
+			}
+			Duration pressedDuration() const {
+				if (not pressed()) {
+					return 0s;
+				}
+				return Duration{ Time() - GetState().pressed_since[std::countr_zero(bit)] };
+			}
+		};
+		inline constexpr Button MouseL{ 1 };
+		inline Button Key(const s3d::Input& key) {
+			const auto i = FindTrackedKey([&](const s3d::Input& k) { return k == key; });
+			assert(i);
+			return Button{ 1u << (*i + 1) };
+		}
+	}
+
+	//シーンに入った最初のフレームでグリフを作って引っかからないように、使う文字を先に読み込んでおく
+	//描いた文字はフォントごとに記録してファイルに残し、次の起動ではそれを描く前に少しずつ読み込む
+	namespace Glyphs {
+		constexpr int32 GuiFont = 0;	//SimpleGUIのフォント。それ以外はAssets::Fontsの大きさ
+
+		struct State {
+			std::mutex mutex;	//Requestはシーンを作るワーカースレッドからも来る
+			HashTable<int32, HashSet<char32>> used;	//描いた文字
+			HashTable<int32, HashSet<char32>> ready;	//読み込み済みか、読み込みを頼んだ文字
+			Array<std::pair<int32, char32>> queue;
+			bool enabled = true;
+		};
+		inline State& GetState() {
+			static State state;
+			return state;
+		}
+
+		//これから描く文字の読み込みを頼む
+		inline void Request(int32 font, StringView text) {
+			auto& state = GetState();
+			std::lock_guard lock(state.mutex);
+			if (not state.enabled) {
+				return;
+			}
+			auto& ready = state.ready[font];
+			for (const char32 c : text) {
+				if (not IsControl(c) && not ready.contains(c)) {
+					ready.emplace(c);
+					state.queue.emplace_back(font, c);
+				}
+			}
+		}
+		//描いたことを記録する。描けばグリフはできているので読み込み済みにもする
+		inline void Note(int32 font, StringView text) {
+			auto& state = GetState();
+			std::lock_guard lock(state.mutex);
+			auto& used = state.used[font];
+			auto& ready = state.ready[font];
+			for (const char32 c : text) {
+				if (not IsControl(c) && not used.contains(c)) {
+					used.emplace(c);
+					ready.emplace(c);
+				}
+			}
+		}
+		inline void SetEnabled(bool enabled) {
+			auto& state = GetState();
+			std::lock_guard lock(state.mutex);
+			state.enabled = enabled;
+			if (not enabled) {
+				state.queue.clear();
+			}
+		}
+		inline size_t Pending() {
+			auto& state = GetState();
+			std::lock_guard lock(state.mutex);
+			return state.queue.size();
+		}
+
+		//1行に フォント<TAB>文字
+		inline void LoadManifest(FilePathView path) {
+			TextReader reader{ path };
+			if (not reader) {
+				return;
+			}
+			for (String line; reader.readLine(line);) {
+				const auto tab = line.indexOf(U'\t');
+				if (tab == String::npos) {
+					continue;
+				}
+				if (const auto font = ParseOpt<int32>(line.substr(0, tab))) {
+					Request(*font, line.substr(tab + 1));
+				}
+			}
+		}
+		inline void SaveManifest(FilePathView path) {
+			auto& state = GetState();
+			std::lock_guard lock(state.mutex);
+			TextWriter writer{ path };
+			if (not writer) {
+				return;
+			}
+			for (const auto& [font, chars] : state.used) {
+				String line = Format(font) + U"\t";
+				for (const char32 c : chars) {
+					line << c;
+				}
+				writer.writeln(line);
+			}
+		}
+	}
+
+	//SimpleGUIの見た目はそのまま、押されたかどうかはInputsから判定する
+	namespace GUI {
+		//描くだけ。GUIをdrawで描くシーン(freezable)はこれとClickedAtに分けて使う
+		inline void DrawButtonAt(StringView label, const Vec2& center, const Optional<double>& width = unspecified, bool enabled = true) {
+			Glyphs::Note(Glyphs::GuiFont, label);
+			SimpleGUI::ButtonAt(label, center, width, enabled);
+		}
+		//押されたかだけ見る
+		inline bool ClickedAt(StringView label, const Vec2& center, const Optional<double>& width = unspecified, bool enabled = true) {
+			return enabled && Inputs::MouseL.down() && SimpleGUI::ButtonRegionAt(label, center, width).intersects(Inputs::CursorPos());
+		}
+		inline bool ButtonAt(StringView label, const Vec2& center, const Optional<double>& width = unspecified, bool enabled = true) {
+			DrawButtonAt(label, center, width, enabled);
+			return ClickedAt(label, center, width, enabled);
+		}
+		inline bool Button(StringView label, const Vec2& pos, const Optional<double>& width = unspecified, bool enabled = true) {
+			Glyphs::Note(Glyphs::GuiFont, label);
+			SimpleGUI::Button(label, pos, width, enabled);
+			return enabled && Inputs::MouseL.down() && SimpleGUI::ButtonRegion(label, pos, width).intersects(Inputs::CursorPos());
+		}
+		inline bool CheckBoxAt(bool& checked, StringView label, const Vec2& center, const Optional<double>& width = unspecified, bool enabled = true) {
+			bool shown = checked;
+			Glyphs::Note(Glyphs::GuiFont, label);
+			SimpleGUI::CheckBoxAt(shown, label, center, width, enabled);
+			if (enabled && Inputs::MouseL.down() && SimpleGUI::CheckBoxRegionAt(label, center, width).intersects(Inputs::CursorPos())) {
+				checked = not checked;
+				return true;
+			}
+			return false;
+		}
+	}
+}
+
+namespace Yeah {
+	//入力から画面に出るまでの遅れの計測と、フレームの待ち方の切り替え
+	namespace Latency {
+		enum class Pacing {
+			VSync,	//垂直同期に任せる
+			LowLatency,	//垂直同期のうえで、Present(と直後の入力の取り込み)を垂直同期の直前まで遅らせる
+			FrameCap,	//垂直同期を切ってフレームレートだけ制限する
+		};
+		inline StringView ToString(Pacing pacing) {
+			switch (pacing) {
+			case Pacing::VSync: return U"vsync";
+			case Pacing::LowLatency: return U"low latency";
+			case Pacing::FrameCap: return U"frame cap";
+			}
+			return U"";
+		}
+
+		//直近の値の分位点
+		class Rolling {
+			static constexpr size_t Window = 512;
+			Array<double> values_;
+			size_t next_ = 0;
+		public:
+			void add(double value) {
+				if (values_.size() < Window) {
+					values_ << value;
+				}
+				else {
+					values_[next_] = value;
+				}
+				next_ = (next_ + 1) % Window;
+			}
+			Optional<double> percentile(double p) const {
+				if (values_.isEmpty()) {
+					return none;
+				}
+				Array<double> sorted = values_;
+				const size_t i = Min(static_cast<size_t>(p * sorted.size()), sorted.size() - 1);
+				std::nth_element(sorted.begin(), sorted.begin() + i, sorted.end());
+				return sorted[i];
+			}
+			size_t size() const {
+				return values_.size();
+			}
+		};
+
+		//1フレームの各時点(μs)。presentはSystem::Updateが戻った時刻なので次のフレームの頭で埋まる
+		//  event → sampled(入力を取り込む) → updated → drawn(描画の発行) → present
+		class Probe {
+			struct Record {
+				uint64 begin = 0;
+				uint64 sampled = 0;
+				uint64 updated = 0;
+				uint64 drawn = 0;
+				Optional<uint64> event;	//このフレームで取り込んだクリックが押された時刻
+			};
+			Optional<Record> current_;
+			Pacing pacing_ = Pacing::VSync;
+			double cap_hz_ = 120.0;
+		public:
+			Rolling click_to_present;	//クリックしてから画面に出るまで(ms)
+			Rolling sample_to_present;	//入力を取り込んでから画面に出るまで(ms)。カーソルに追従するものの遅れ
+			Rolling work;	//取り込みから描画の発行まで(ms)
+			Rolling interval;	//フレームの間隔(ms)
+
+			void setPacing(Pacing pacing) {
+				pacing_ = pacing;
+				Graphics::SetVSyncEnabled(pacing != Pacing::FrameCap);
+				Graphics::SetTargetFrameRateHz(pacing == Pacing::FrameCap ? Optional<double>{ cap_hz_ } : none);
+			}
+			Pacing pacing() const {
+				return pacing_;
+			}
+
+			//System::Updateが戻った直後に呼ぶ。前のフレームを締める
+			void frameBegin() {
+				const uint64 now = Time::GetMicrosec();
+				if (current_) {
+					const auto& r = *current_;
+					interval.add((now - r.begin) / 1e3);
+					sample_to_present.add((now - r.sampled) / 1e3);
+					work.add((r.drawn - r.sampled) / 1e3);
+					if (r.event) {
+						click_to_present.add((now - *r.event) / 1e3);
+					}
+				}
+				current_ = Record{ now, now };	//入力はSystem::Updateの中で取り込まれているので、取り込みの時刻もここ
+			}
+			//ループの最後、次のSystem::Updateの直前に呼ぶ。LowLatencyなら次の垂直同期の少し前まで待つ
+			//入力はSystem::Updateの中(Presentの後)で取り込まれるので、待つのはその前でないと入力は新しくならない
+			void waitForPresent() {
+				if (pacing_ != Pacing::LowLatency || not current_ || interval.size() < 60) {
+					return;
+				}
+				//frameBeginはPresentが垂直同期を待って戻った直後なので、1フレーム後が次の垂直同期
+				//2msは残りの描画の発行とPresentの余裕
+				const double deadline = current_->begin + *interval.percentile(0.5) * 1e3 - 2'000;
+				const double wait = deadline - static_cast<double>(Time::GetMicrosec());
+				if (wait > 0.0) {
+					std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64>(wait)));
+				}
+			}
+			//Inputs::Updateの後に呼ぶ。このフレームで取り込んだクリックを拾う
+			void inputSampled() {
+				if (not current_) { return; }
+				if (Inputs::MouseL.down()) {
+					current_->event = current_->sampled - Inputs::GetState().current.press_lead;
+				}
+			}
+			void updated() {
+				if (current_) { current_->updated = Time::GetMicrosec(); }
+			}
+			void drawn() {
+				if (current_) { current_->drawn = Time::GetMicrosec(); }
+			}
+
+			void draw(const Font& font, const Vec2& pos) const {
+				const auto line = [&](StringView label, const Rolling& r) {
+					if (not r.size()) {
+						return String{ label } + U" -";
+					}
+					return U"{} p50 {:.1f} / p95 {:.1f} / p99 {:.1f} ms"_fmt(label, *r.percentile(0.5), *r.percentile(0.95), *r.percentile(0.99));
+				};
+				font(U"pacing: {} (F6)"_fmt(ToString(pacing_))).draw(pos, Palette::Yellow);
+				font(line(U"click → present", click_to_present)).draw(pos + Vec2(0, 18), Palette::White);
+				font(line(U"sample → present", sample_to_present)).draw(pos + Vec2(0, 36), Palette::White);
+				font(line(U"sample → draw", work)).draw(pos + Vec2(0, 54), Palette::White);
+				font(line(U"frame", interval)).draw(pos + Vec2(0, 72), Palette::White);
+			}
+		};
+	}
+}
+
+namespace Yeah {
+	//シーンから使うワークスティーリングのスレッドプール。SceneChangerが持ち、シーンはIScene::jobs()から使う
+	namespace Jobs {
+		class Scheduler {
+			struct Worker {
+				std::mutex mutex;
+				std::deque<std::function<void()>> queue;	//持ち主は後ろから、盗むほうは前から取る
+			};
+			Array<std::unique_ptr<Worker>> workers_;
+			Array<std::thread> threads_;
+			std::mutex sleep_mutex_;
+			std::condition_variable wake_;
+			std::atomic<size_t> queued_{ 0 };
+			std::atomic<size_t> next_{ 0 };
+			std::atomic<bool> stop_{ false };
+			static inline thread_local const Scheduler* owner_ = nullptr;
+			static inline thread_local size_t self_ = 0;
+			static inline std::atomic<Scheduler*> current_{ nullptr };
+		public:
+			explicit Scheduler(size_t threads = Max<size_t>(std::thread::hardware_concurrency(), 2) - 1) {
+				for (size_t i = 0; i < threads; ++i) {
+					workers_ << std::make_unique<Worker>();
+				}
+				for (size_t i = 0; i < threads; ++i) {
+					threads_ << std::thread([this, i]() { workerLoop(i); });
+				}
+			}
+			~Scheduler() {
+				stop_ = true;
+				{
+					std::lock_guard lock(sleep_mutex_);
+				}
+				wake_.notify_all();
+				for (auto& thread : threads_) {
+					thread.join();
+				}
+			}
+			Scheduler(const Scheduler&) = delete;
+			Scheduler& operator=(const Scheduler&) = delete;
+
+			//jobs()が使うスケジューラ。なければその場で実行する
+			static Scheduler* Current() {
+				return current_.load();
+			}
+			static Scheduler* SetCurrent(Scheduler* scheduler) {	//前のものを返す
+				return current_.exchange(scheduler);
+			}
+			size_t threadCount() const {
+				return workers_.size();
+			}
+
+			//ワーカーからなら自分のキュー、それ以外は順番に配る
+			void submit(std::function<void()> job) {
+				const size_t target = (owner_ == this) ? self_ : next_++ % workers_.size();
+				{
+					std::lock_guard lock(workers_[target]->mutex);
+					workers_[target]->queue.push_back(std::move(job));
+				}
+				++queued_;
+				{
+					std::lock_guard lock(sleep_mutex_);	//寝る直前の判定とすれ違わないように
+				}
+				wake_.notify_one();
+			}
+			//待っている間に手伝う。何か実行したらtrue
+			bool runOne() {
+				const size_t self = (owner_ == this) ? self_ : next_.load() % workers_.size();
+				for (size_t k = 0; k < workers_.size(); ++k) {
+					auto& worker = *workers_[(self + k) % workers_.size()];
+					std::function<void()> job;
+					{
+						std::lock_guard lock(worker.mutex);
+						if (worker.queue.empty()) {
+							continue;
+						}
+						if (k == 0 && owner_ == this) {
+							job = std::move(worker.queue.back());
+							worker.queue.pop_back();
+						}
+						else {
+							job = std::move(worker.queue.front());
+							worker.queue.pop_front();
+						}
+					}
+					--queued_;
+					job();
+					return true;
+				}
+				return false;
+			}
+
+		private:
+			void workerLoop(size_t index) {
+				owner_ = this;
+				self_ = index;
+				while (not stop_) {
+					if (runOne()) {
+						continue;
+					}
+					std::unique_lock lock(sleep_mutex_);
+					wake_.wait(lock, [this]() { return stop_ || queued_ > 0; });
+				}
+			}
+		};
+
+		//[begin, end)をgrainずつに分けて並列にf(b, e)する。呼んだスレッドも手伝い、全部終わるまで戻らない
+		template<typename F>
+		void ParallelFor(size_t begin, size_t end, size_t grain, F&& f) {
+			grain = Max<size_t>(grain, 1);
+			Scheduler* scheduler = Scheduler::Current();
+			if (not scheduler || end - begin <= grain) {
+				f(begin, end);
+				return;
+			}
+			struct Loop {
+				std::atomic<size_t> next;
+				std::atomic<size_t> remaining;
+			};
+			const size_t chunks = (end - begin + grain - 1) / grain;
+			auto loop = std::make_shared<Loop>();
+			loop->next = begin;
+			loop->remaining = chunks;
+			const auto work = [loop, end, grain, &f, account = Memory::Tracking::current]() {
+				const Memory::Charge charge{ account };
+				for (size_t b; (b = loop->next.fetch_add(grain)) < end;) {
+					f(b, Min(b + grain, end));
+					--loop->remaining;
+				}
+			};
+			//チャンクを取り終えてから始まった手伝いは何もせず抜けるので、fが消えた後に触ることはない
+			for (size_t i = 1; i < Min(chunks, scheduler->threadCount() + 1); ++i) {
+				scheduler->submit(work);
+			}
+			work();
+			while (loop->remaining > 0) {
+				if (not scheduler->runOne()) {
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		//SceneChanger::updateの頭で受け取る結果。メインスレッドからだけ触る
+		template<typename T>
+		class Future {
+			struct Shared {
+				Optional<T> value;
+			};
+			std::shared_ptr<Shared> shared_ = std::make_shared<Shared>();
+			friend class Context;
+		public:
+			bool isReady() const {
+				return shared_->value.has_value();
+			}
+			T& get() {
+				return *shared_->value;
+			}
+		};
+
+		//シーンごとの仕事の持ち主。シーンを離れるとcancelされ、まだ始まっていない仕事と結果は捨てられる
+		class Context {
+			struct State {
+				std::atomic<bool> cancelled{ false };
+				std::atomic<size_t> outstanding{ 0 };	//投げてまだ終わっていない数
+				std::mutex mutex;
+				Array<std::function<void()>> completions;	//メインスレッドで呼ぶ
+
+				void complete(std::function<void()> f) {
+					if (cancelled) {
+						return;
+					}
+					std::lock_guard lock(mutex);
+					completions << std::move(f);
+				}
+			};
+			std::shared_ptr<State> state_ = std::make_shared<State>();
+			Array<std::shared_ptr<State>> cancelled_;	//取り消したが走っているかもしれないもの
+		public:
+			Context() = default;
+			Context(const Context&) = delete;
+			Context& operator=(const Context&) = delete;
+			~Context() {
+				shutdown();
+			}
+
+			//fをワーカーで走らせ、戻り値をSceneChanger::updateの頭でメインスレッドのthenに渡す
+			template<typename F, typename Then>
+			void submit(F&& f, Then&& then) {
+				Spawn(state_, [state = state_.get(), f = std::forward<F>(f), then = std::forward<Then>(then)]() mutable {
+					if constexpr (std::is_void_v<std::invoke_result_t<F&>>) {
+						f();
+						state->complete(std::move(then));
+					}
+					else {
+						state->complete([then = std::move(then), result = f()]() mutable { then(std::move(result)); });
+					}
+				});
+			}
+			template<typename F>
+			auto async(F&& f) {
+				using T = std::invoke_result_t<F&>;
+				Future<T> future;
+				submit(std::forward<F>(f), [shared = future.shared_](T&& value) { shared->value = std::move(value); });
+				return future;
+			}
+
+			//依存関係つきの仕事。addした順に番号が振られる。全部終わったらthenがメインスレッドで呼ばれる
+			class Graph {
+				friend class Context;
+				struct Node {
+					std::function<void()> f;
+					Array<size_t> dependents;
+					size_t dependencies = 0;
+				};
+				Array<Node> nodes_;
+			public:
+				size_t add(std::function<void()> f, std::initializer_list<size_t> after = {}) {
+					const size_t id = nodes_.size();
+					nodes_ << Node{ std::move(f), {}, after.size() };
+					for (const size_t a : after) {
+						nodes_[a].dependents << id;
+					}
+					return id;
+				}
+			};
+			void run(Graph&& graph, std::function<void()> then = nullptr) {
+				struct Run {
+					Array<Graph::Node> nodes;
+					std::unique_ptr<std::atomic<size_t>[]> waiting;
+					std::atomic<size_t> remaining;
+					std::function<void()> then;
+				};
+				auto run = std::make_shared<Run>();
+				run->nodes = std::move(graph.nodes_);
+				run->waiting = std::make_unique<std::atomic<size_t>[]>(run->nodes.size());
+				run->remaining = run->nodes.size();
+				run->then = std::move(then);
+				if (run->nodes.isEmpty()) {
+					if (run->then) {
+						state_->complete(std::move(run->then));
+					}
+					return;
+				}
+				for (size_t i = 0; i < run->nodes.size(); ++i) {
+					run->waiting[i] = run->nodes[i].dependencies;
+				}
+				for (size_t i = 0; i < run->nodes.size(); ++i) {
+					if (run->nodes[i].dependencies == 0) {
+						RunNode(state_, run, i);
+					}
+				}
+			}
+
+			//メインスレッドで、終わった仕事のthenを呼ぶ
+			void collect() {
+				Array<std::function<void()>> completions;
+				{
+					std::lock_guard lock(state_->mutex);
+					completions.swap(state_->completions);
+				}
+				for (auto& f : completions) {
+					f();
+				}
+				cancelled_.remove_if([](const std::shared_ptr<State>& s) { return s->outstanding == 0; });
+			}
+			//まだ始まっていない仕事を捨てる。走っているものは最後まで走るが結果は届かない
+			void cancel() {
+				if (state_->outstanding == 0) {
+					std::lock_guard lock(state_->mutex);
+					state_->completions.clear();
+					return;
+				}
+				state_->cancelled = true;
+				cancelled_ << std::exchange(state_, std::make_shared<State>());
+			}
+			//取り消して、走っているものが終わるまで待つ。シーンを破棄する前に呼ぶ
+			void shutdown() {
+				cancel();
+				for (const auto& state : cancelled_) {
+					while (state->outstanding > 0) {
+						if (auto* scheduler = Scheduler::Current(); not scheduler || not scheduler->runOne()) {
+							std::this_thread::yield();
+						}
+					}
+				}
+				cancelled_.clear();
+			}
+			size_t pending() const {
+				return state_->outstanding;
+			}
+
+		private:
+			static void Spawn(const std::shared_ptr<State>& state, std::function<void()> body) {
+				++state->outstanding;
+				auto job = [state, body = std::move(body), account = Memory::Tracking::current]() {
+					const Memory::Charge charge{ account };	//投げた側の勘定に付ける
+					if (not state->cancelled) {
+						try {
+							body();
+						}
+						catch (...) {
+							state->complete([e = std::current_exception()]() { std::rethrow_exception(e); });	//メインスレッドで投げ直す
+						}
+					}
+					--state->outstanding;
+				};
+				if (auto* scheduler = Scheduler::Current()) {
+					scheduler->submit(std::move(job));
+				}
+				else {
+					job();
+				}
+			}
+			template<typename Run>
+			static void RunNode(const std::shared_ptr<State>& state, const std::shared_ptr<Run>& run, size_t index) {
+				Spawn(state, [state, run, index]() {
+					run->nodes[index].f();
+					for (const size_t d : run->nodes[index].dependents) {
+						if (--run->waiting[d] == 0) {
+							RunNode(state, run, d);
+						}
+					}
+					if (--run->remaining == 0 && run->then) {
+						state->complete(std::move(run->then));
+					}
+				});
+			}
+		};
+	}
+}
+
+namespace Yeah {
+	//終了したときのシーン履歴と状態を残して、次の起動で続きから始める
+	//"YEAHSES1" シーンの数(uint32) 今の位置(uint32)
+	//  シーンごとに 名前の長さ(uint32) 名前(UTF-8) 状態の長さ(uint32) 状態
+	namespace Session {
+		constexpr uint64 Magic = 0x3153454848414559;	//"YEAHSES1"
+
+		//シーンの状態を書き出す。読む側(Reader)と同じ順に書く
+		class Writer {
+			Array<Byte> bytes_;
+			Array<std::pair<size_t, std::function<void(Writer&)>>> deferred_;	//bytes_のこの位置に、後でワーカーが書く
+		public:
+			template<typename T>
+			void write(const T& value) {
+				static_assert(std::is_trivially_copyable_v<T>);
+				write(&value, sizeof(T));
+			}
+			void write(const void* data, size_t size) {
+				const Byte* p = static_cast<const Byte*>(data);
+				bytes_.insert(bytes_.end(), p, p + size);
+			}
+			template<typename T>
+			void writeArray(const Array<T>& values) {
+				static_assert(std::is_trivially_copyable_v<T>);
+				write(static_cast<uint32>(values.size()));
+				write(values.data(), values.size_bytes());
+			}
+			void writeString(StringView s) {
+				const std::string utf8 = Unicode::ToUTF8(s);
+				write(static_cast<uint32>(utf8.size()));
+				write(utf8.data(), utf8.size());
+			}
+			//重い書き出しをセッションを書くワーカーに回す。fには今の状態の複製(shared_ptrなど)を持たせ、シーン本体には触らない
+			void defer(std::function<void(Writer&)> f) {
+				deferred_.emplace_back(bytes_.size(), std::move(f));
+			}
+			//deferした分を書いて並べる
+			Array<Byte> finish() && {
+				if (deferred_.isEmpty()) {
+					return std::move(bytes_);
+				}
+				Writer out;
+				size_t at = 0;
+				for (auto& [position, f] : deferred_) {
+					out.write(bytes_.data() + at, position - at);
+					at = position;
+					f(out);
+				}
+				out.write(bytes_.data() + at, bytes_.size() - at);
+				return std::move(out).finish();
+			}
+		};
+		//シーン1つ分の状態。deferした分は最初に読まれたとき(書き出しのワーカー)に一度だけ詰める
+		class State {
+			mutable std::once_flag once_;
+			mutable Writer writer_;
+			mutable Array<Byte> bytes_;
+		public:
+			explicit State(Writer&& writer) :
+				writer_(std::move(writer)) {}
+			const Array<Byte>& bytes() const {
+				std::call_once(once_, [this]() { bytes_ = std::move(writer_).finish(); });
+				return bytes_;
+			}
+		};
+		//メモリマップしたファイルをそのまま読む。足りなければ0を返してok()がfalseになる
+		class Reader {
+			const Byte* p_;
+			const Byte* end_;
+			bool ok_ = true;
+		public:
+			Reader(const Byte* data, size_t size) :
+				p_(data),
+				end_(data + size) {}
+
+			template<typename T>
+			T read() {
+				static_assert(std::is_trivially_copyable_v<T>);
+				T value{};
+				if (const Byte* p = readBytes(sizeof(T))) {
+					std::memcpy(&value, p, sizeof(T));
+				}
+				return value;
+			}
+			const Byte* readBytes(size_t size) {
+				if (not ok_ || static_cast<size_t>(end_ - p_) < size) {
+					ok_ = false;
+					return nullptr;
+				}
+				const Byte* p = p_;
+				p_ += size;
+				return p;
+			}
+			template<typename T>
+			Array<T> readArray() {
+				const uint32 count = read<uint32>();
+				Array<T> values;
+				if (const Byte* p = readBytes(static_cast<size_t>(count) * sizeof(T))) {
+					values.resize(count);
+					std::memcpy(values.data(), p, values.size_bytes());
+				}
+				return values;
+			}
+			String readString() {
+				const uint32 size = read<uint32>();
+				const Byte* p = readBytes(size);
+				return p ? Unicode::FromUTF8(std::string_view(reinterpret_cast<const char*>(p), size)) : String{};
+			}
+			bool ok() const {
+				return ok_;
+			}
+		};
+
+		//書き出す中身。状態は変わっていないシーンの分を前回から使い回す
+		struct Image {
+			struct Scene {
+				String name;
+				std::shared_ptr<const State> state;
+			};
+			Array<Scene> scenes;
+			uint32 current = 0;
+		};
+		//一時ファイルに書いてから置き換える。ワーカースレッドから呼ぶ
+		inline bool Save(const FilePath& path, const Image& image) {
+			const FilePath temporary = path + U".tmp";
+			{
+				BinaryWriter writer{ temporary };
+				if (not writer) {
+					return false;
+				}
+				writer.write(Magic);
+				writer.write(static_cast<uint32>(image.scenes.size()));
+				writer.write(image.current);
+				for (const auto& scene : image.scenes) {
+					const std::string name = Unicode::ToUTF8(scene.name);
+					writer.write(static_cast<uint32>(name.size()));
+					writer.write(name.data(), name.size());
+					const Array<Byte>& state = scene.state->bytes();
+					writer.write(static_cast<uint32>(state.size()));
+					writer.write(state.data(), state.size_bytes());
+				}
+			}
+			std::error_code error;
+			std::filesystem::rename(std::filesystem::path(temporary.toWstr()), std::filesystem::path(path.toWstr()), error);
+			return not error;
+		}
+
+		//一定間隔でワーカーに書かせる。前の書き込みが終わっていなければ次の機会に回す
+		class Saver {
+			FilePath path_;
+			Stopwatch since_{ StartImmediately::Yes };
+			Duration interval_;
+			AsyncTask<bool> task_;
+		public:
+			Saver(FilePathView path, const Duration& interval) :
+				path_(path),
+				interval_(interval) {}
+			~Saver() {
+				if (task_.isValid()) {
+					task_.wait();
+				}
+			}
+			bool due() const {
+				return since_.elapsed() >= interval_ && not (task_.isValid() && not task_.isReady());
+			}
+			void save(std::shared_ptr<const Image> image) {
+				if (task_.isValid()) {
+					task_.get();
+				}
+				task_ = Async([path = path_, image = std::move(image)]() { return Save(path, *image); });
+				since_.restart();
+			}
+			//終了時。書き終わるまで待つ
+			void flush(std::shared_ptr<const Image> image) {
+				save(std::move(image));
+				task_.get();
+			}
+		};
+	}
+}
+
+class SceneFactory {
+	static inline std::atomic<Yeah::Memory::IAllocator*> allocator_{ nullptr };
+public:
+	//シーンオブジェクトの確保先(nullptrならヒープ)
+	static Yeah::Memory::IAllocator* SetAllocator(Yeah::Memory::IAllocator* allocator) { return allocator_.exchange(allocator); }	//前のものを返す
+	static Yeah::Memory::IAllocator& Allocator() {
+		auto* allocator = allocator_.load();
+		return allocator ? *allocator : Yeah::Memory::Heap();
+	}
+
+	template<typename T, typename...Args>
+	static std::unique_ptr<Yeah::Scenes::IScene> Create(Args&&...args);
+	template<typename T, typename...Args>
+	static AsyncTask<std::unique_ptr<Yeah::Scenes::IScene>> CreateAsync(Args&&...args);	//ワーカースレッドでCreateする
+	//セッションから作り直す。TはSessionNameを持ち、Session::Reader&を取るコンストラクタがあればそれで状態を戻す
+	template<typename T>
+	static std::unique_ptr<Yeah::Scenes::IScene> Restore(Yeah::Session::Reader& reader);
+	static std::unique_ptr<Yeah::Scenes::IScene> Restore(StringView name, Yeah::Session::Reader& reader);	//知らない名前ならnullptr
+};
+namespace Yeah {
+	namespace Scenes {
+		//IScene::checksum用。値のバイト列をFNV-1aで混ぜる。パディングのある型は要素ごとに足す
+		class Checksum {
+			uint32 hash_ = 2166136261u;
+		public:
+			template<typename T>
+			Checksum& add(const T& value) {
+				static_assert(std::is_trivially_copyable_v<T>);
+				return bytes(&value, sizeof(T));
+			}
+			Checksum& bytes(const void* data, size_t size) {
+				const uint8* p = static_cast<const uint8*>(data);
+				for (size_t i = 0; i < size; ++i) {
+					hash_ = (hash_ ^ p[i]) * 16777619u;
+				}
+				return *this;
+			}
+			uint32 value() const {
+				return hash_;
+			}
+		};
+
+		class IScene {
+			friend class SceneChanger;
+			friend class ::SceneFactory;
+
+			std::function<std::unique_ptr<IScene>()> recreate_;	//履歴から追い出されたときに作り直す
+			Jobs::Context jobs_;
+			size_t footprint_ = 0;	//オブジェクト自体の大きさ
+			Memory::Account* account_ = nullptr;	//SceneFactoryが開く。このシーンの確保を付ける
+			StringView session_name_;	//SceneFactoryが入れる。空ならセッションに残さない
+
+			struct AsyncChange {
+				AsyncTask<std::unique_ptr<IScene>> scene;
+				Duration fade_out, fade_in;
+				bool freeze;
+			};
+			struct {
+				bool exit_ = false;
+				Optional<std::pair<std::unique_ptr<IScene>, std::unique_ptr<Transitions::ITransition>>> change_;
+				Optional<AsyncChange> change_async_;
+				Optional<std::unique_ptr<Transitions::ITransition>> undo_;
+				Optional<std::unique_ptr<Transitions::ITransition>> redo_;
+
+				void resetOptional() {
+					change_.reset();
+					change_async_.reset();
+					undo_.reset();
+					redo_.reset();
+				}
+			} request_;
+		public:
+			//unique_ptrの型はそのままに、確保先だけSceneFactoryのアロケータに切り替える
+			static void* operator new(size_t size) {
+				return Memory::Allocate(SceneFactory::Allocator(), size);
+			}
+			static void operator delete(void* p, size_t size) {
+				Memory::Deallocate(p, size);
+			}
+
+			virtual ~IScene() {
+				if (account_) {
+					//派生クラスのメンバは解放済み。recreate_・jobs_はこの後に解放されるが、勘定は空になるまで使い回さないのでそれも付く
+					Memory::GetLedger().close(account_);
+				}
+			}
+			virtual void load() {}	//作られた後に一度だけメインスレッドで呼ばれる(GPUを触る準備はここで)
+			virtual void initialize() {}	//シーンが呼ばれたとき(undo・redoでも呼ばれる)
+
+			virtual void update() = 0;
+			virtual void draw() const = 0;
+
+			virtual void updateFadeIn(double /*t*/) { update(); }
+			virtual void updateFadeOut(double /*t*/) { update(); }
+			virtual void drawFadeIn(double /*t*/) const { draw(); }
+			virtual void drawFadeOut(double /*t*/) const { draw(); }
+
+			//パイプライン(任意)。1フレームは update → (simulate と draw を並行) → 次のフレームの頭で publish
+			//  update  : メインスレッドで単独で走る。入力・GUI・乱数・シーン切り替えの要求はここだけ
+			//  simulate: ワーカースレッドでdrawと同時に走る。drawが読むもの・入力・グローバルな乱数には触らない
+			//  publish : メインスレッド。simulateの結果をdrawが読む側へ移す
+			//  draw    : メインスレッド。simulateが書いているものは読まない
+			virtual bool pipelined() const { return false; }
+			virtual void simulate() {}
+			virtual void publish() {}
+
+			//記録の再生がずれていないかの確認に使う、ゲームの状態のハッシュ。updateの後、simulateと並行に呼ばれる
+			//simulateが書くものは読まない。入力と乱数だけで決まるものを入れる(0なら型と履歴の位置だけで見る)
+			virtual uint32 checksum() const { return 0; }
+
+			//drawだけで見た目が全部出るならtrue。GUIをupdateで描くシーンはfalseのままにする
+			//trueのシーンだけSnapshotで画像にして止めたままフェードさせる(falseなら普通にフェードする)
+			virtual bool freezable() const { return false; }
+
+			//オブジェクトの外に持っているメモリ(ヒープ・テクスチャなど)の見積もり
+			virtual size_t memoryUsage() const { return 0; }
+			size_t totalMemoryUsage() const { return footprint_ + memoryUsage(); }
+			Memory::Account* allocationAccount() const { return account_; }
+
+			//セッションに残す状態。SessionNameを持つシーンだけ呼ばれる。Session::Reader&を取るコンストラクタで同じ順に読む
+			//メインスレッドでsimulateと並行に呼ばれることがあるので、simulateが書くものは読まない
+			virtual void save(Session::Writer& /*writer*/) const {}
+
+			//ワーカーに投げる仕事。結果はSceneChanger::updateの頭で届き、このシーンを離れると取り消される
+			Jobs::Context& jobs() {
+				return jobs_;
+			}
+
+			void exit() {
+				request_.exit_ = true;
+			}
+			void changeScene(std::unique_ptr<IScene>&& scene,
+				std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
+				request_.change_ = std::make_pair(std::move(scene), std::move(transition));
+			}
+			//次のシーンを作りながらフェードアウトし、両方終わったらフェードインする
+			//freezeなら自分を画像にしてからフェードアウトする(フェード中のupdate・drawを省く)。freezable()なシーンだけ
+			void changeScene(AsyncTask<std::unique_ptr<IScene>>&& scene,
+				const Duration& fadeOutTime, const Duration& fadeInTime, bool freeze = false) {
+				request_.change_async_ = AsyncChange{ std::move(scene), fadeOutTime, fadeInTime, freeze };
+			}
+			void undo(std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
+				request_.undo_ = std::move(transition);
+			}
+			void redo(std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
+				request_.redo_ = std::move(transition);
+			}
+		};
+	}
+}
+
+class TransitionFactory {
+	static inline std::atomic<Yeah::Memory::IAllocator*> allocator_{ nullptr };
+public:
+	//遷移オブジェクトの確保先(nullptrならヒープ)
+	static Yeah::Memory::IAllocator* SetAllocator(Yeah::Memory::IAllocator* allocator) { return allocator_.exchange(allocator); }	//前のものを返す
+	static Yeah::Memory::IAllocator& Allocator() {
+		auto* allocator = allocator_.load();
+		return allocator ? *allocator : Yeah::Memory::Heap();
+	}
+
+	template<typename T, typename...Args>
+	static std::unique_ptr<Yeah::Transitions::ITransition> Create(Args&&...args);
+};
+namespace Yeah {
+	namespace Transitions {
+		class ITransition {
+		public:
+			static void* operator new(size_t size) {
+				return Memory::Allocate(TransitionFactory::Allocator(), size);
+			}
+			static void operator delete(void* p, size_t size) {
+				Memory::Deallocate(p, size);
+			}
+
+			virtual ~ITransition() = default;
+			virtual void update(const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) = 0;
+			virtual void draw(const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) const = 0;
+
+			virtual Optional<std::unique_ptr<ITransition>> nextTransition() const = 0;
+		};
+
+		class Step :public ITransition {
+		public:
+			void update([[maybe_unused]] const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) override {
+				if (after) {
+					const Profiler::Scope scope{ "update", *after };
+					const Memory::Charge charge{ after->allocationAccount() };
+					after->update();
+				}
+			}
+			void draw([[maybe_unused]] const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) const override {
+				if (after) {
+					const Profiler::Scope scope{ "draw", *after };
+					const Memory::Charge charge{ after->allocationAccount() };
+					after->draw();
+				}
+			}
+
+			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
+				return none;
+			}
+		};
+
+		//値で組み立てる遷移。各要素は開始からの経過秒だけを見て描くので、合成してもヒープを使わない
+		namespace Fades {
+			using ScenePtr = std::unique_ptr<Scenes::IScene>;
+
+			//遷移元を消していく
+			struct FadeOut {
+				double length_;
+				FadeOut(const Duration& length) :
+					length_(length.count()) {}
+				double length() const { return length_; }
+				void update(double e, const ScenePtr& before, [[maybe_unused]] const ScenePtr& after) const {
+					if (before) {
+						const double t = 1.0 - Saturate(e / length_);
+						const ScopedColorMul2D s(1.0, t);
+						const Profiler::Scope scope{ "updateFadeOut", *before };
+						const Memory::Charge charge{ before->allocationAccount() };
+						before->updateFadeOut(t);
+					}
+				}
+				void draw(double e, const ScenePtr& before, [[maybe_unused]] const ScenePtr& after) const {
+					if (before) {
+						const double t = 1.0 - Saturate(e / length_);
+						const ScopedColorMul2D s(1.0, t);
+						const Profiler::Scope scope{ "drawFadeOut", *before };
+						const Memory::Charge charge{ before->allocationAccount() };
+						before->drawFadeOut(t);
+					}
+				}
+			};
+			//遷移先を出していく
+			struct FadeIn {
+				double length_;
+				FadeIn(const Duration& length) :
+					length_(length.count()) {}
+				double length() const { return length_; }
+				void update(double e, [[maybe_unused]] const ScenePtr& before, const ScenePtr& after) const {
+					if (after) {
+						const double t = Saturate(e / length_);
+						const ScopedColorMul2D s(1.0, t);
+						const Profiler::Scope scope{ "updateFadeIn", *after };
+						const Memory::Charge charge{ after->allocationAccount() };
+						after->updateFadeIn(t);
+					}
+				}
+				void draw(double e, [[maybe_unused]] const ScenePtr& before, const ScenePtr& after) const {
+					if (after) {
+						const double t = Saturate(e / length_);
+						const ScopedColorMul2D s(1.0, t);
+						const Profiler::Scope scope{ "drawFadeIn", *after };
+						const Memory::Charge charge{ after->allocationAccount() };
+						after->drawFadeIn(t);
+					}
+				}
+			};
+			//遷移元をそのまま見せて待つ
+			struct Hold {
+				double length_;
+				Hold(const Duration& length) :
+					length_(length.count()) {}
+				double length() const { return length_; }
+				void update(double, const ScenePtr& before, const ScenePtr&) const {
+					if (before) {
+						const Profiler::Scope scope{ "update", *before };
+						const Memory::Charge charge{ before->allocationAccount() };
+						before->update();
+					}
+				}
+				void draw(double, const ScenePtr& before, const ScenePtr&) const {
+					if (before) {
+						const Profiler::Scope scope{ "draw", *before };
+						const Memory::Charge charge{ before->allocationAccount() };
+						before->draw();
+					}
+				}
+			};
+
+			//AのあとにB
+			template<typename A, typename B>
+			struct Seq {
+				A a_;
+				B b_;
+				template<typename X, typename Y>
+				Seq(X&& a, Y&& b) :
+					a_(std::forward<X>(a)),
+					b_(std::forward<Y>(b)) {}
+				double length() const { return a_.length() + b_.length(); }
+				void update(double e, const ScenePtr& before, const ScenePtr& after) const {
+					if (e < a_.length()) { a_.update(e, before, after); }
+					else { b_.update(e - a_.length(), before, after); }
+				}
+				void draw(double e, const ScenePtr& before, const ScenePtr& after) const {
+					if (e < a_.length()) { a_.draw(e, before, after); }
+					else { b_.draw(e - a_.length(), before, after); }
+				}
+			};
+			//AとBを同時に(Bが上)
+			template<typename A, typename B>
+			struct Par {
+				A a_;
+				B b_;
+				template<typename X, typename Y>
+				Par(X&& a, Y&& b) :
+					a_(std::forward<X>(a)),
+					b_(std::forward<Y>(b)) {}
+				double length() const { return Max(a_.length(), b_.length()); }
+				void update(double e, const ScenePtr& before, const ScenePtr& after) const {
+					a_.update(Min(e, a_.length()), before, after);
+					b_.update(Min(e, b_.length()), before, after);
+				}
+				void draw(double e, const ScenePtr& before, const ScenePtr& after) const {
+					a_.draw(Min(e, a_.length()), before, after);
+					b_.draw(Min(e, b_.length()), before, after);
+				}
+			};
+			//Aの進み方をイージング関数で変える
+			template<typename A, typename F>
+			struct Eased {
+				A a_;
+				F f_;
+				double length() const { return a_.length(); }
+				void update(double e, const ScenePtr& before, const ScenePtr& after) const {
+					a_.update(map(e), before, after);
+				}
+				void draw(double e, const ScenePtr& before, const ScenePtr& after) const {
+					a_.draw(map(e), before, after);
+				}
+			private:
+				double map(double e) const {
+					return f_(Saturate(e / a_.length())) * a_.length();
+				}
+			};
+			//Aの長さをfactor倍にする
+			template<typename A>
+			struct Stretched {
+				A a_;
+				double factor_;
+				double length() const { return a_.length() * factor_; }
+				void update(double e, const ScenePtr& before, const ScenePtr& after) const {
+					a_.update(e / factor_, before, after);
+				}
+				void draw(double e, const ScenePtr& before, const ScenePtr& after) const {
+					a_.draw(e / factor_, before, after);
+				}
+			};
+
+			template<typename A, typename B>
+			auto Then(A&& a, B&& b) { return Seq<std::decay_t<A>, std::decay_t<B>>(std::forward<A>(a), std::forward<B>(b)); }
+			template<typename A, typename B>
+			auto With(A&& a, B&& b) { return Par<std::decay_t<A>, std::decay_t<B>>(std::forward<A>(a), std::forward<B>(b)); }
+			template<typename A, typename F>
+			auto Ease(A&& a, F f) { return Eased<std::decay_t<A>, F>{ std::forward<A>(a), f }; }
+			template<typename A>
+			auto Stretch(A&& a, double factor) { return Stretched<std::decay_t<A>>{ std::forward<A>(a), factor }; }
+		}
+
+		//値の遷移をITransitionとして扱うためのアダプタ。終わった後はStepと同じ動きをするので次の遷移を作らない
+		template<typename Expr>
+		class Composed :public ITransition {
+			Expr expr_;
+			Stopwatch stopwatch_{ StartImmediately::Yes, Inputs::Clock() };
+		public:
+			template<typename...Args, std::enable_if_t<std::is_constructible_v<Expr, Args&&...>>* = nullptr>
+			Composed(Args&&...args) :
+				expr_(std::forward<Args>(args)...) {}
+			void update(const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) override {
+				if (const double e = stopwatch_.sF(); e < expr_.length()) {
+					expr_.update(e, before, after);
+				}
+				else if (after) {
+					const Profiler::Scope scope{ "update", *after };
+					const Memory::Charge charge{ after->allocationAccount() };
+					after->update();
+				}
+			}
+			void draw(const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) const override {
+				if (const double e = stopwatch_.sF(); e < expr_.length()) {
+					expr_.draw(e, before, after);
+				}
+				else if (after) {
+					const Profiler::Scope scope{ "draw", *after };
+					const Memory::Charge charge{ after->allocationAccount() };
+					after->draw();
+				}
+			}
+
+			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
+				return none;
+			}
+		};
+		template<typename Expr>
+		std::unique_ptr<ITransition> Compose(Expr&& expr) {
+			return TransitionFactory::Create<Composed<std::decay_t<Expr>>>(std::forward<Expr>(expr));
+		}
+
+		using AlphaFadeOut = Composed<Fades::FadeOut>;
+		using AlphaFadeIn = Composed<Fades::FadeIn>;
+		using AlphaFadeInOut = Composed<Fades::Seq<Fades::FadeOut, Fades::FadeIn>>;
+		//ひとつの長さで前後のシーンを同時にフェードする(従来のCrossFade(fadeTime)と同じ呼び方)
+		class CrossFade :public Composed<Fades::Par<Fades::FadeIn, Fades::FadeOut>> {
+		public:
+			CrossFade(const Duration& fadeTime) :
+				Composed(Fades::FadeIn{ fadeTime }, Fades::FadeOut{ fadeTime }) {}
+		};
+		static_assert(std::is_constructible_v<CrossFade, const Duration&>, "CrossFade(fadeTime)が壊れている");
+
+		template<typename FadeOutT, typename FadeInT>
+		class CustomFadeInOut :public ITransition {
+			Timer timer;
+			const Duration fadeOutTime, fadeInTime;
+			Optional<FadeOutT> fadeOut;
+			Optional<FadeInT> fadeIn;
+		public:
+			CustomFadeInOut(const Duration& fadeOutTime, const Duration& fadeInTime) :
+				timer(fadeOutTime + fadeInTime, StartImmediately::Yes, Inputs::Clock()),
+				fadeInTime(fadeInTime),
+				fadeOutTime(fadeOutTime),
+				fadeOut(FadeOutT{ fadeOutTime }) {}
+			void update(const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) override {
+				if (not fadeIn && timer.remaining() < fadeInTime) {
+					fadeIn.emplace(fadeInTime);
+				}
+				if (timer.remaining() < fadeInTime) {
+					if (fadeIn) {
+						fadeIn->update(before, after);
+					}
+				}
+				else {
+					if (fadeOut) {
+						fadeOut->update(before, after);
+					}
+				}
+			}
+			void draw(const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) const override {
+				if (timer.remaining() < fadeInTime) {
+					if (fadeIn) {
+						fadeIn->draw(before, after);
+					}
+				}
+				else {
+					if (fadeOut) {
+						fadeOut->draw(before, after);
+					}
+				}
+			}
+
+			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
+				if (timer.reachedZero()) {
+					return Optional<std::unique_ptr<ITransition>>(TransitionFactory::Create<Transitions::Step>());
+				}
+				else {
+					return none;
+				}
+			}
+		};
+
+		template<typename FadeOutT, typename FadeInT>
+		class CustomCrossFade :public ITransition {
+			Timer timer;
+			FadeOutT fadeOut;
+			FadeInT fadeIn;
+		public:
+			CustomCrossFade(const Duration& fadeTime) :
+				timer(fadeTime, StartImmediately::Yes, Inputs::Clock()),
+				fadeOut(FadeOutT{ fadeTime }),
+				fadeIn(FadeInT{ fadeTime }) {}
+			void update(const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) override {
+				fadeIn.update(before, after);
+				fadeOut.update(before, after);
+			}
+			void draw(const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) const override {
+				fadeIn.draw(before, after);
+				fadeOut.draw(before, after);
+			}
+
+			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
+				if (timer.reachedZero()) {
+					return Optional<std::unique_ptr<ITransition>>(TransitionFactory::Create<Transitions::Step>());
+				}
+				else {
+					return none;
+				}
+			}
+		};
+
+		//シーンを一度だけオフスクリーンに描いて止めた画像。更新も再描画もしない
+		//画像にするのはdrawだけなので、updateでGUIを描くシーン(freezable()がfalse)は撮らない
+		class Snapshot :public Scenes::IScene {
+			MSRenderTexture texture_;
+		public:
+			Snapshot(const Scenes::IScene& scene) :
+				texture_(Scene::Size(), Scene::GetBackground()) {
+				{
+					const ScopedRenderTarget2D target(texture_);
+					scene.draw();
+				}
+				Graphics2D::Flush();
+				texture_.resolve();
+			}
+			void update() override {}
+			void draw() const override {
+				texture_.draw();
+			}
+			size_t memoryUsage() const override {
+				return Memory::Estimate(texture_);
+			}
+
+			//撮れないシーンならnullptr。呼ぶ側は元のシーンをそのまま使う
+			static std::unique_ptr<Scenes::IScene> Capture(const std::unique_ptr<Scenes::IScene>& scene) {
+				return scene && scene->freezable() ? std::make_unique<Snapshot>(*scene) : nullptr;
+			}
+		};
+
+		//遷移元のシーンを最初のフレームで画像にして、以降はそれをTでフェードさせる
+		template<typename T>
+		class FrozenOut :public ITransition {
+			T transition_;
+			std::unique_ptr<Scenes::IScene> snapshot_;
+			bool captured_ = false;
+		public:
+			template<typename...Args>
+			FrozenOut(Args&&...args) :
+				transition_(std::forward<Args>(args)...) {}
+			void update(const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) override {
+				if (not captured_) {
+					snapshot_ = Snapshot::Capture(before);
+					captured_ = true;
+				}
+				transition_.update(snapshot_ ? snapshot_ : before, after);
+			}
+			void draw(const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) const override {
+				transition_.draw(snapshot_ ? snapshot_ : before, after);
+			}
+
+			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
+				return transition_.nextTransition();
+			}
+		};
+
+		//非同期で次のシーンを作っている間。今のシーンをフェードアウトし、長引いたら読み込み中の表示を出す
+		class PendingFadeOut :public ITransition {
+			Timer timer;
+			Stopwatch waiting{ StartImmediately::Yes, Inputs::Clock() };
+			const Duration fadeOutTime;
+			const bool freeze_;	//今のシーンを画像にしてからフェードさせる
+			std::unique_ptr<Scenes::IScene> snapshot_;
+			bool captured_ = false;
+		public:
+			PendingFadeOut(const Duration& fadeOutTime, bool freeze = false) :
+				timer(fadeOutTime, StartImmediately::Yes, Inputs::Clock()),
+				fadeOutTime(fadeOutTime),
+				freeze_(freeze) {}
+			void update([[maybe_unused]] const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) override {
+				if (freeze_ && not captured_) {
+					snapshot_ = Snapshot::Capture(after);
+					captured_ = true;
+				}
+				const auto& outgoing = snapshot_ ? snapshot_ : after;
+				if (outgoing && not timer.reachedZero()) {
+					const ScopedColorMul2D s(1.0, timer.progress1_0());
+					const Profiler::Scope scope{ "updateFadeOut", *outgoing };
+					const Memory::Charge charge{ outgoing->allocationAccount() };
+					outgoing->updateFadeOut(timer.progress1_0());
+				}
+			}
+			void draw([[maybe_unused]] const std::unique_ptr<Scenes::IScene>& before,
+				const std::unique_ptr<Scenes::IScene>& after) const override {
+				const auto& outgoing = snapshot_ ? snapshot_ : after;
+				if (not timer.reachedZero()) {
+					if (outgoing) {
+						const ScopedColorMul2D s(1.0, timer.progress1_0());
+						const Profiler::Scope scope{ "drawFadeOut", *outgoing };
+						const Memory::Charge charge{ outgoing->allocationAccount() };
+						outgoing->drawFadeOut(timer.progress1_0());
+					}
+				}
+				else if (waiting.elapsed() > fadeOutTime + 0.2s) {	//すぐ終わるときはちらつかないように出さない
+					Circle(Scene::Center(), 24).drawArc(Inputs::Time() * 360_deg, 270_deg, 4, 0, ColorF(1.0, 0.8));
+				}
+			}
+
+			//切り替えはSceneChangerがシーンの完成を待って行う
+			Optional<std::unique_ptr<ITransition>> nextTransition() const override {
+				return none;
+			}
+		};
+	}
+}
+
+namespace Yeah {
+	class SceneChanger {
+	public:
+		//履歴の上限。超えたら古いものから捨てる
+		struct HistoryLimit {
+			size_t depth = 64;	//保持する履歴の数
+			size_t bytes = 256 << 20;	//生きているシーンの合計
+		};
+		struct HistoryInfo {
+			String name;
+			size_t bytes;	//追い出されていれば0
+			bool alive;
+			bool current;
+			int64 live_bytes = 0, peak_bytes = 0;	//このシーンに付いたヒープ確保
+		};
+
+	private:
+		//このSceneChangerが作るシーン・遷移の確保先。中身より後に破棄されるよう先頭に置く
+		Memory::PoolAllocator scene_pool_;
+		Memory::ArenaAllocator transition_arena_;
+		//SceneChangerが複数あっても(ベンチマークとアプリなど)、壊れたら前のものに戻す。作った逆順に壊す前提
+		struct Installer {
+			Memory::IAllocator* previous_scenes;
+			Memory::IAllocator* previous_transitions;
+			Installer(Memory::IAllocator* scenes, Memory::IAllocator* transitions) :
+				previous_scenes(SceneFactory::SetAllocator(scenes)),
+				previous_transitions(TransitionFactory::SetAllocator(transitions)) {}
+			~Installer() {
+				SceneFactory::SetAllocator(previous_scenes);
+				TransitionFactory::SetAllocator(previous_transitions);
+			}
+		} installer_{ &scene_pool_, &transition_arena_ };
+		//シーンの仕事を回すスレッドプール。シーンより後に破棄されるようscenes_より前に置く
+		Jobs::Scheduler scheduler_;
+		struct SchedulerInstaller {
+			Jobs::Scheduler* previous;
+			SchedulerInstaller(Jobs::Scheduler* scheduler) : previous(Jobs::Scheduler::SetCurrent(scheduler)) {}
+			~SchedulerInstaller() { Jobs::Scheduler::SetCurrent(previous); }
+		} scheduler_installer_{ &scheduler_ };
+		uint64 heap_at_change_ = 0, heap_per_change_ = 0;
+
+		struct Entry {
+			std::unique_ptr<Scenes::IScene> scene;
+			std::function<std::unique_ptr<Scenes::IScene>()> recreate;
+			String name;
+			uint64 last_used = 0;
+			String session_name;
+			std::shared_ptr<const Session::State> session;	//最後に書き出した状態。今と直前のシーン以外は変わらない
+		};
+		Array<Entry> scenes_;
+		bool pipelined_ = false;
+		Scenes::IScene* simulated_ = nullptr;
+		std::atomic<bool> simulating_{ false };	//scheduler_でsimulate中。SceneChangerを壊す前に待つ
+		std::exception_ptr simulation_error_;
+		Optional<int64> before_index_, after_index_;
+		std::unique_ptr<Transitions::ITransition> transition_ = TransitionFactory::Create<Transitions::CrossFade>(1s);
+		HistoryLimit limit_;
+		uint64 clock_ = 0;	//LRU用
+
+		struct PendingChange {
+			AsyncTask<std::unique_ptr<Scenes::IScene>> scene;
+			Timer fade_out;
+			Duration fade_in;
+		};
+		Optional<PendingChange> pending_;	//作成中の次のシーン
+
+		//シーンに入ってからEntryFrames間で一番重かったフレーム(update+draw)
+		static constexpr uint32 EntryFrames = 60;
+		mutable uint64 frame_ns_ = 0;	//drawでも足す
+		uint64 entry_peak_ns_ = 0, entry_hitch_ns_ = 0, worst_entry_hitch_ns_ = 0;
+		uint32 entry_window_ = 0;
+		struct FrameTime {
+			uint64& total;
+			uint64 begin = Time::GetNanosec();
+			~FrameTime() { total += Time::GetNanosec() - begin; }
+		};
+	public:
+		SceneChanger() = default;
+		~SceneChanger() {
+			waitSimulation();
+			for (auto& entry : scenes_) {
+				release(entry);
+			}
+		}
+		SceneChanger(
+			std::unique_ptr<Scenes::IScene>&& scene,
+			std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
+			change(std::move(scene), std::move(transition));
+		}
+
+		void setTransition(std::unique_ptr<Transitions::ITransition>&& transition) {
+			if (not transition) { return; }
+
+			transition_ = std::move(transition);
+		}
+		//trueならsimulateをワーカースレッドでdrawと並行に回す。falseでも呼ばれる順番と結果は同じ
+		void setPipelined(bool pipelined) {
+			pipelined_ = pipelined;
+		}
+		bool isPipelined() const {
+			return pipelined_;
+		}
+		void setHistoryLimit(const HistoryLimit& limit) {
+			limit_ = limit;
+			trimHistory();
+		}
+		void change(std::unique_ptr<Scenes::IScene>&& next, std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
+			if (not next) { return; }
+
+			if (after_index_) {
+				for (size_t i = *after_index_ + 1; i < scenes_.size(); ++i) {
+					release(scenes_[i]);
+				}
+				scenes_.dropBack(scenes_.size() - 1 - *after_index_);
+			}
+
+			const uint64 heap = Memory::GetStats().heap_allocations;
+			heap_per_change_ = heap - heap_at_change_;
+			heap_at_change_ = heap;
+
+			next->load();
+			auto recreate = std::move(next->recreate_);
+			String name = Unicode::Widen(typeid(*next).name());
+			String session_name{ next->session_name_ };
+			scenes_ << Entry{ std::move(next), std::move(recreate), std::move(name), 0, std::move(session_name) };
+
+			before_index_ = after_index_;
+			if (after_index_) {
+				++(*after_index_);
+			}
+			else {
+				after_index_ = 0;
+			}
+			
+			activate();
+
+			setTransition(std::move(transition));
+		}
+		void redo(std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
+			if (not after_index_) { return; }
+			if (scenes_.size() <= *after_index_ + 1) { return; }
+
+			before_index_ = after_index_;
+			++(*after_index_);
+
+			activate();
+
+			setTransition(std::move(transition));
+		}
+		void undo(std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
+			if (not after_index_) { return; }
+			if (*after_index_ <= 0) { return; }
+
+			before_index_ = after_index_;
+			--(*after_index_);
+
+			activate();
+
+			setTransition(std::move(transition));
+		}
+
+		bool update() {
+			const Profiler::Scope scope{ "SceneChanger::update" };
+			const Memory::During during{ Memory::Phase::Update };
+			closeFrame();
+			const FrameTime time{ frame_ns_ };
+			finishSimulation();
+			//ワーカーに投げた仕事の結果はここで届く
+			if (after()) {
+				const Memory::Charge charge{ after()->allocationAccount() };
+				after()->jobs_.collect();
+			}
+			if (before()) {
+				const Memory::Charge charge{ before()->allocationAccount() };
+				before()->jobs_.collect();
+			}
+			if (transition_) {
+				const Profiler::Scope transitionScope{ "update", *transition_ };
+				const Memory::Charge charge{ Memory::TransitionAccount() };
+				transition_->update(before(), after());
+			}
+
+			if (after() && pending_) {
+				after()->request_.resetOptional();	//作成中は他の要求を受け付けない
+			}
+			if (after()) {
+				if (after()->request_.change_async_) {
+					auto& request = *after()->request_.change_async_;
+					pending_ = PendingChange{ std::move(request.scene), Timer(request.fade_out, StartImmediately::Yes, Inputs::Clock()), request.fade_in };
+					setTransition(TransitionFactory::Create<Transitions::PendingFadeOut>(request.fade_out, request.freeze));
+				}
+				if (after()->request_.change_) {
+					change(
+						std::move(after()->request_.change_->first),
+						std::move(after()->request_.change_->second)
+					);
+				}
+				if (after()->request_.undo_) {
+					undo(std::move(*after()->request_.undo_));
+				}
+				if (after()->request_.redo_) {
+					redo(std::move(*after()->request_.redo_));
+				}
+			}
+			if (after()) {
+				after()->request_.resetOptional();
+			}
+			if (before()) {
+				before()->request_.resetOptional();
+			}
+
+			if (pending_ && pending_->fade_out.reachedZero() && Inputs::Ready(pending_->scene)) {
+				auto next = pending_->scene.get();
+				const Duration fadeInTime = pending_->fade_in;
+				pending_.reset();
+				change(std::move(next), TransitionFactory::Create<Transitions::AlphaFadeIn>(fadeInTime));
+			}
+
+			//if (KeyU.down()) {
+			//	undo(TransitionFactory::Create<Transitions::AlphaFadeInOut>(0.4s, 0.4s));
+			//}
+			//if (KeyR.down()) {
+			//	redo(TransitionFactory::Create<Transitions::AlphaFadeInOut>(0.4s, 0.4s));
+			//}
+
+			if (transition_) {
+				if (auto&& i = transition_->nextTransition(); i.has_value()) {
+					setTransition(std::move(*i));
+				}
+			}
+
+			startSimulation();
+
+			return after() ? not after()->request_.exit_ : true;
+		}
+		void draw() const {
+			const Profiler::Scope scope{ "SceneChanger::draw" };
+			const Memory::During during{ Memory::Phase::Draw };
+			const FrameTime time{ frame_ns_ };
+			if (transition_) {
+				const Profiler::Scope transitionScope{ "draw", *transition_ };
+				const Memory::Charge charge{ Memory::TransitionAccount() };
+				transition_->draw(before(), after());
+			}
+		}
+
+		//履歴と各シーンの状態をセッションにする。update()の外で呼ぶ
+		//残せないシーンは飛ばし、今のシーンが残せなければその手前から再開する
+		//ここでは状態の複製を取るだけで、大きな状態はSessionのdeferで書き出しのワーカーが詰める
+		std::shared_ptr<const Session::Image> snapshot() {
+			auto image = std::make_shared<Session::Image>();
+			for (auto&& [i, entry] : Indexed(scenes_)) {
+				if (entry.session_name.isEmpty()) {
+					continue;
+				}
+				const bool active = (after_index_ && static_cast<int64>(i) == *after_index_) || (before_index_ && static_cast<int64>(i) == *before_index_);
+				if (entry.scene && (active || not entry.session)) {
+					Session::Writer writer;
+					entry.scene->save(writer);
+					entry.session = std::make_shared<const Session::State>(std::move(writer));
+				}
+				if (not entry.session) {
+					continue;	//状態を取る前に追い出された
+				}
+				image->scenes << Session::Image::Scene{ entry.session_name, entry.session };
+				if (after_index_ && static_cast<int64>(i) <= *after_index_) {
+					image->current = static_cast<uint32>(image->scenes.size() - 1);
+				}
+			}
+			return image;
+		}
+		//snapshotを書いたファイルから履歴を作り直す。使えなければfalseで、何も変えない
+		bool resume(FilePathView path, std::unique_ptr<Transitions::ITransition>&& transition = nullptr) {
+			MemoryMappedFileView view{ path };
+			if (not view) {
+				return false;
+			}
+			const auto mapped = view.mapAll();
+			Session::Reader reader{ mapped.data, mapped.size };
+			if (reader.read<uint64>() != Session::Magic) {
+				return false;
+			}
+			const uint32 count = reader.read<uint32>();
+			const uint32 current = reader.read<uint32>();
+			Array<Entry> entries;
+			Optional<size_t> current_index;
+			for (uint32 i = 0; i < count && reader.ok(); ++i) {
+				const String session_name = reader.readString();
+				const uint32 size = reader.read<uint32>();
+				const Byte* state = reader.readBytes(size);
+				if (not state) {
+					break;
+				}
+				Session::Reader scene_reader{ state, size };
+				auto scene = SceneFactory::Restore(session_name, scene_reader);
+				if (not scene) {
+					continue;	//今のビルドにないシーンは飛ばす
+				}
+				scene->load();
+				auto recreate = std::move(scene->recreate_);
+				String name = Unicode::Widen(typeid(*scene).name());
+				Session::Writer saved;
+				saved.write(state, size);
+				entries << Entry{ std::move(scene), std::move(recreate), std::move(name), 0, session_name,
+					std::make_shared<const Session::State>(std::move(saved)) };
+				if (i <= current) {
+					current_index = entries.size() - 1;
+				}
+			}
+			if (entries.isEmpty()) {
+				return false;
+			}
+
+			waitSimulation();
+			simulated_ = nullptr;
+			pending_.reset();
+			for (auto& entry : scenes_) {
+				release(entry);
+			}
+			scenes_ = std::move(entries);
+			before_index_ = none;
+			after_index_ = static_cast<int64>(current_index.value_or(0));
+			activate();
+			setTransition(std::move(transition));
+			return true;
+		}
+
+		//履歴の各シーンのメモリ使用量
+		Array<HistoryInfo> history() const {
+			Array<HistoryInfo> result;
+			for (const auto& [i, entry] : Indexed(scenes_)) {
+				const Memory::Account* account = entry.scene ? entry.scene->allocationAccount() : nullptr;
+				result << HistoryInfo{
+					entry.name,
+					entry.scene ? entry.scene->totalMemoryUsage() : 0,
+					static_cast<bool>(entry.scene),
+					after_index_ && static_cast<int64>(i) == *after_index_,
+					account ? account->liveBytes() : 0,
+					account ? account->peakBytes() : 0
+				};
+			}
+			return result;
+		}
+		//シーンに入った直後の一番重いフレーム。グリフの先読みの効果をこれで見る
+		Duration entryHitch() const {
+			return Duration{ entry_hitch_ns_ / 1e9 };
+		}
+		Duration worstEntryHitch() const {
+			return Duration{ worst_entry_hitch_ns_ / 1e9 };
+		}
+		//直前のシーン切り替えから次の切り替えまでにシーン・遷移の確保でヒープまで行った回数
+		uint64 heapAllocationsPerChange() const {
+			return heap_per_change_;
+		}
+		//今のシーンの位置・型・状態のハッシュ。記録の再生がずれていないかの確認用
+		uint32 checkpoint() const {
+			if (not after()) {
+				return 0;
+			}
+			const uint32 position = static_cast<uint32>(std::hash<std::string_view>{}(typeid(*after()).name()) ^ (*after_index_ * 0x9e3779b9u));
+			return Scenes::Checksum{}.add(position).add(after()->checksum()).value();
+		}
+		size_t memoryUsage() const {
+			size_t bytes = 0;
+			for (const auto& entry : scenes_) {
+				bytes += entry.scene ? entry.scene->totalMemoryUsage() : 0;
+			}
+			return bytes;
+		}
+
+	private:
+		void startSimulation() {
+			if (not after() || not after()->pipelined()) {
+				return;
+			}
+			simulated_ = after().get();
+			if (pipelined_) {
+				simulating_ = true;
+				scheduler_.submit([this, scene = simulated_]() {
+					try {
+						const Profiler::Scope scope{ "simulate", *scene };
+						const Memory::Charge charge{ scene->allocationAccount() };
+						const Memory::During during{ Memory::Phase::Simulate };
+						scene->simulate();
+					}
+					catch (...) {
+						simulation_error_ = std::current_exception();	//finishSimulationで投げ直す
+					}
+					simulating_ = false;
+				});
+			}
+			else {
+				const Profiler::Scope scope{ "simulate", *simulated_ };
+				const Memory::Charge charge{ simulated_->allocationAccount() };
+				const Memory::During during{ Memory::Phase::Simulate };
+				simulated_->simulate();
+			}
+		}
+		//ParallelForと同じく、待つ間はスケジューラの仕事を手伝う
+		void waitSimulation() {
+			while (simulating_) {
+				if (not scheduler_.runOne()) {
+					std::this_thread::yield();
+				}
+			}
+		}
+		void finishSimulation() {
+			waitSimulation();
+			if (simulation_error_) {
+				std::rethrow_exception(std::exchange(simulation_error_, nullptr));
+			}
+			if (simulated_) {
+				const Memory::Charge charge{ simulated_->allocationAccount() };
+				simulated_->publish();
+				simulated_ = nullptr;
+			}
+		}
+
+		//after_index_に来たシーンを使える状態にする
+		void activate() {
+			if (before()) {
+				before()->jobs_.cancel();	//離れたシーンの仕事は取り消す
+			}
+			auto& entry = scenes_[*after_index_];
+			if (not entry.scene && entry.recreate) {
+				entry.scene = entry.recreate();
+				entry.scene->recreate_ = nullptr;
+				entry.scene->load();
+			}
+			entry.last_used = ++clock_;
+			entry_window_ = EntryFrames;
+			entry_peak_ns_ = 0;
+
+			if (after()) {
+				after()->initialize();
+			}
+
+			trimHistory();
+		}
+
+		void closeFrame() {
+			if (entry_window_ > 0) {
+				entry_peak_ns_ = Max(entry_peak_ns_, frame_ns_);
+				if (--entry_window_ == 0) {
+					entry_hitch_ns_ = entry_peak_ns_;
+					worst_entry_hitch_ns_ = Max(worst_entry_hitch_ns_, entry_hitch_ns_);
+				}
+			}
+			frame_ns_ = 0;
+		}
+		//上限を超えた分を捨てる。遷移中のシーンとその両隣は残す
+		void trimHistory() {
+			//先頭が今の近くでも、その先に消せる古いものがあれば消す
+			while (scenes_.size() > Max<size_t>(limit_.depth, 1)) {
+				Optional<size_t> oldest;
+				for (size_t i = 0; i < scenes_.size(); ++i) {
+					if (isRemovable(i)) {
+						oldest = i;
+						break;
+					}
+				}
+				if (not oldest) {
+					break;
+				}
+				release(scenes_[*oldest]);
+				scenes_.erase(scenes_.begin() + *oldest);
+				if (before_index_ && *before_index_ > static_cast<int64>(*oldest)) { --(*before_index_); }
+				if (after_index_ && *after_index_ > static_cast<int64>(*oldest)) { --(*after_index_); }
+			}
+
+			for (size_t bytes = memoryUsage(); bytes > limit_.bytes;) {
+				Optional<size_t> victim;
+				for (const auto& [i, entry] : Indexed(scenes_)) {
+					if (entry.scene && entry.recreate && isRemovable(i)
+						&& (not victim || entry.last_used < scenes_[*victim].last_used)) {
+						victim = i;
+					}
+				}
+				if (not victim) {
+					break;
+				}
+				bytes -= scenes_[*victim].scene->totalMemoryUsage();
+				release(scenes_[*victim]);	//作り直せるものだけ追い出す
+			}
+		}
+		//仕事がthisを掴んでいるかもしれないので、派生クラスが壊れる前に待つ
+		static void release(Entry& entry) {
+			if (entry.scene) {
+				entry.scene->jobs_.shutdown();
+				entry.scene.reset();
+			}
+		}
+		bool isRemovable(size_t index) const {
+			const auto i = static_cast<int64>(index);
+			if (before_index_ && i == *before_index_) { return false; }
+			if (after_index_ && Abs(i - *after_index_) <= 1) { return false; }
+			return true;
+		}
+
+		std::unique_ptr<Yeah::Scenes::IScene>& before() {
+			static std::unique_ptr<Yeah::Scenes::IScene> nul{ nullptr };
+			return before_index_ ? scenes_[*before_index_].scene : nul;
+		}
+		const std::unique_ptr<Yeah::Scenes::IScene>& before() const {
+			static std::unique_ptr<Yeah::Scenes::IScene> nul{ nullptr };
+			return before_index_ ? scenes_[*before_index_].scene : nul;
+		}
+		std::unique_ptr<Yeah::Scenes::IScene>& after() {
+			static std::unique_ptr<Yeah::Scenes::IScene> nul{ nullptr };
+			return after_index_ ? scenes_[*after_index_].scene : nul;
+		}
+		const std::unique_ptr<Yeah::Scenes::IScene>& after() const {
+			static std::unique_ptr<Yeah::Scenes::IScene> nul{ nullptr };
+			return after_index_ ? scenes_[*after_index_].scene : nul;
+		}
+	};
+}
+
+namespace Yeah {
+	namespace Assets {
+		//記述子をキーにしたプロセス共通のアセット。参照カウントを持ち、初めて使われたときに読み込む
+		template<typename Key, typename Asset>
+		class Registry {
+			struct Entry {
+				Optional<Asset> asset;
+				int32 refs = 0;
+				bool pinned = false;	//preloadしたものは参照がなくなっても残す
+			};
+			std::mutex mutex_;	//参照の増減はシーンを作るワーカースレッドからも来る
+			HashTable<Key, Entry> entries_;
+			Asset(*load_)(const Key&);
+		public:
+			explicit Registry(Asset(*load)(const Key&)) :
+				load_(load) {}
+
+			void acquire(const Key& key) {
+				const Memory::Charge charge{ Memory::Shared() };
+				std::lock_guard lock(mutex_);
+				++entries_[key].refs;
+			}
+			void release(const Key& key) {
+				std::lock_guard lock(mutex_);
+				if (auto it = entries_.find(key); it != entries_.end() && --it->second.refs <= 0 && not it->second.pinned) {
+					entries_.erase(it);
+				}
+			}
+			//読み込みはGPUを触るのでメインスレッドから呼ぶ
+			Asset get(const Key& key) {
+				const Memory::Charge charge{ Memory::Shared() };
+				std::lock_guard lock(mutex_);
+				auto& entry = entries_[key];
+				if (not entry.asset) {
+					entry.asset = load_(key);
+				}
+				return *entry.asset;
+			}
+			//誰かが使っているものだけ返す
+			Optional<Asset> find(const Key& key) {
+				const Memory::Charge charge{ Memory::Shared() };
+				std::lock_guard lock(mutex_);
+				auto it = entries_.find(key);
+				if (it == entries_.end()) {
+					return none;
+				}
+				if (not it->second.asset) {
+					it->second.asset = load_(key);
+				}
+				return it->second.asset;
+			}
+			void preload(const Key& key) {
+				const Memory::Charge charge{ Memory::Shared() };
+				std::lock_guard lock(mutex_);
+				auto& entry = entries_[key];
+				entry.pinned = true;
+				if (not entry.asset) {
+					entry.asset = load_(key);
+				}
+			}
+			//エンジンが終了する前に手放す
+			void clear() {
+				std::lock_guard lock(mutex_);
+				entries_.clear();
+			}
+			size_t size() {
+				std::lock_guard lock(mutex_);
+				return entries_.size();
+			}
+		};
+
+		inline Registry<int32, Font>& Fonts() {
+			static Registry<int32, Font> registry{ [](const int32& size) { return Font{ size }; } };
+			return registry;
+		}
+		inline Registry<String, Texture>& Emojis() {
+			static Registry<String, Texture> registry{ [](const String& emoji) { return Texture{ Emoji(emoji) }; } };
+			return registry;
+		}
+		inline void Clear() {
+			Fonts().clear();
+			Emojis().clear();
+		}
+
+		//レジストリの参照。実体は最初に描画するときに取りに行く
+		template<typename Key, typename Asset, Registry<Key, Asset>&(*Get)()>
+		class Ref {
+			Key key_;
+			mutable Optional<Asset> asset_;
+		public:
+			explicit Ref(const Key& key) :
+				key_(key) {
+				Get().acquire(key_);
+			}
+			Ref(const Ref& other) :
+				Ref(other.key_) {}
+			Ref& operator=(const Ref&) = delete;
+			~Ref() {
+				asset_.reset();
+				Get().release(key_);
+			}
+
+			const Asset& get() const {
+				if (not asset_) {
+					asset_ = Get().get(key_);
+				}
+				return *asset_;
+			}
+			const Key& key() const { return key_; }
+		};
+
+		class FontRef :public Ref<int32, Font, Fonts> {
+		public:
+			using Ref::Ref;
+			template<typename...Args>
+			DrawableText operator()(const Args&...args) const {
+				DrawableText text = get()(args...);
+				Glyphs::Note(key(), text.text);
+				return text;
+			}
+		};
+		using EmojiRef = Ref<String, Texture, Emojis>;
+
+		//頼まれたグリフをbudgetの間だけ読み込む。フォントのテクスチャに書くのでメインスレッドで毎フレーム呼ぶ
+		inline void PrewarmGlyphs(const Duration& budget) {
+			auto& state = Glyphs::GetState();
+			const uint64 begin = Time::GetNanosec();
+			const Memory::Charge charge{ Memory::Shared() };
+			while (Time::GetNanosec() - begin < static_cast<uint64>(budget.count() * 1e9)) {
+				std::pair<int32, char32> next;
+				{
+					std::lock_guard lock(state.mutex);
+					if (state.queue.isEmpty()) {
+						return;
+					}
+					next = state.queue.front();
+					state.queue.pop_front();
+				}
+				const auto& [font, c] = next;
+				if (font == Glyphs::GuiFont) {
+					SimpleGUI::GetFont().preload(StringView(&c, 1));
+				}
+				else if (const auto found = Fonts().find(font)) {	//使われていない大きさは読み込まない
+					found->preload(StringView(&c, 1));
+				}
+			}
+		}
+
+		//毎フレーム同じ文字列を描くときのグリフの並び。作ったときにグリフの読み込みを頼み、最初に描くときに並びを作って使い回す
+		class StaticText {
+			FontRef font_;
+			String text_;
+			mutable Array<Glyph> glyphs_;
+			mutable Array<Vec2> offsets_;	//左上からの位置
+			mutable SizeF size_{ 0, 0 };
+		public:
+			StaticText(int32 size, StringView text) :
+				font_(size),
+				text_(text) {
+				Glyphs::Request(size, text_);
+			}
+
+			//メインスレッドで並びを作っておく(loadから呼ぶ)
+			void prepare() const {
+				if (not glyphs_.isEmpty() || text_.isEmpty()) {
+					return;
+				}
+				const Font& font = font_.get();
+				Vec2 pen{ 0, 0 };
+				for (const auto& glyph : font.getGlyphs(text_)) {
+					if (glyph.codePoint == U'\n') {
+						pen = Vec2{ 0, pen.y + font.height() };
+						continue;
+					}
+					glyphs_ << glyph;
+					offsets_ << pen + glyph.getOffset();
+					pen.x += glyph.xAdvance;
+					size_.x = Max(size_.x, pen.x);
+				}
+				size_.y = pen.y + font.height();
+				Glyphs::Note(font_.key(), text_);
+			}
+			RectF drawAt(const Vec2& center, const ColorF& color = Palette::White) const {
+				prepare();
+				const Vec2 tl = center - size_ / 2;
+				for (size_t i = 0; i < glyphs_.size(); ++i) {
+					glyphs_[i].texture.draw(tl + offsets_[i], color);
+				}
+				return RectF{ tl, size_ };
+			}
+		};
+	}
+
+	namespace Effects {
+		//固定容量のパーティクル。SoAで持ち、フレーム中の確保はしない
+		class ParticleSystem {
+			static constexpr size_t ChunkSize = 16384;	//Vertex2D::IndexTypeがuint16なので1チャンク65536頂点まで
+			static constexpr float Gravity = 600.0f;
+			static constexpr float ParticleSize = 3.0f;
+
+			size_t capacity_ = 0;
+			size_t size_ = 0;
+			Array<float> x_, y_, vx_, vy_, life_, inv_life_, r_, g_, b_;
+			std::array<Array<Buffer2D>, 2> chunks_;	//描画用。prepareで裏に書いてpublishで表と入れ替える。最大同時数に達したときだけ増える
+			std::array<size_t, 2> counts_{};
+			size_t front_ = 0;
+			size_t chunk_bytes_ = 0;	//publishで数える。prepareがワーカーでchunks_を増やしている間も読めるように
+		public:
+			ParticleSystem() = default;
+			explicit ParticleSystem(size_t capacity) :
+				capacity_(capacity),
+				x_(capacity), y_(capacity), vx_(capacity), vy_(capacity),
+				life_(capacity), inv_life_(capacity), r_(capacity), g_(capacity), b_(capacity) {}
+
+			size_t size() const { return size_; }
+			size_t capacity() const { return capacity_; }
+			size_t memoryUsage() const {
+				return capacity_ * 9 * sizeof(float) + chunk_bytes_;
+			}
+
+			//空きがなければ溢れた分は捨てる
+			void emit(const Vec2& pos, const ColorF& color, int32 count, double speed, const Duration& lifeTime = 0.8s) {
+				const size_t n = Min(static_cast<size_t>(Max(count, 0)), capacity_ - size_);
+				for (size_t i = size_; i < size_ + n; ++i) {
+					const Vec2 v = Circular(Random(speed), Random(Math::TwoPi)).toVec2();
+					const double life = lifeTime.count() * Random(0.5, 1.0);
+					x_[i] = static_cast<float>(pos.x);
+					y_[i] = static_cast<float>(pos.y);
+					vx_[i] = static_cast<float>(v.x);
+					vy_[i] = static_cast<float>(v.y);
+					life_[i] = static_cast<float>(life);
+					inv_life_[i] = static_cast<float>(1.0 / life);
+					r_[i] = static_cast<float>(color.r);
+					g_[i] = static_cast<float>(color.g);
+					b_[i] = static_cast<float>(color.b);
+				}
+				size_ += n;
+			}
+
+			void update(double deltaTime) {
+				const float dt = static_cast<float>(deltaTime);
+				float* const x = x_.data();
+				float* const y = y_.data();
+				float* const vx = vx_.data();
+				float* const vy = vy_.data();
+				float* const life = life_.data();
+
+				//分岐のない単純なループにしてベクトル化させる
+				for (size_t i = 0; i < size_; ++i) {
+					vy[i] += Gravity * dt;
+					x[i] += vx[i] * dt;
+					y[i] += vy[i] * dt;
+					life[i] -= dt;
+				}
+
+				//寿命切れは末尾と入れ替えて詰める
+				for (size_t i = 0; i < size_;) {
+					if (life[i] > 0.0f) {
+						++i;
+						continue;
+					}
+					const size_t last = --size_;
+					x_[i] = x_[last]; y_[i] = y_[last];
+					vx_[i] = vx_[last]; vy_[i] = vy_[last];
+					life_[i] = life_[last]; inv_life_[i] = inv_life_[last];
+					r_[i] = r_[last]; g_[i] = g_[last]; b_[i] = b_[last];
+				}
+			}
+
+			//裏の頂点を今の状態で作る。GPUには触らないのでワーカースレッドからでもよい
+			void prepare() {
+				auto& chunks = chunks_[1 - front_];
+				for (size_t begin = 0, chunk = 0; begin < size_; begin += ChunkSize, ++chunk) {
+					if (chunks.size() <= chunk) {
+						chunks << makeChunk();
+					}
+					const size_t count = Min(ChunkSize, size_ - begin);
+					Vertex2D* v = chunks[chunk].vertices.data();
+					for (size_t i = begin; i < begin + count; ++i, v += 4) {
+						const Float4 color{ r_[i], g_[i], b_[i], Min(life_[i] * inv_life_[i], 1.0f) };
+						const float l = x_[i] - ParticleSize * 0.5f, t = y_[i] - ParticleSize * 0.5f;
+						const float r = l + ParticleSize, b = t + ParticleSize;
+						v[0].pos = { l,t }; v[1].pos = { r,t }; v[2].pos = { l,b }; v[3].pos = { r,b };
+						v[0].color = v[1].color = v[2].color = v[3].color = color;
+					}
+				}
+				counts_[1 - front_] = size_;
+			}
+			void publish() {
+				front_ = 1 - front_;
+				chunk_bytes_ = (chunks_[0].size() + chunks_[1].size()) * (ChunkSize * 4 * sizeof(Vertex2D) + ChunkSize * 2 * sizeof(TriangleIndex));
+			}
+			//最後にpublishした頂点を描く
+			void draw() const {
+				const auto& chunks = chunks_[front_];
+				for (size_t begin = 0, chunk = 0; begin < counts_[front_]; begin += ChunkSize, ++chunk) {
+					chunks[chunk].drawSubset(0, static_cast<uint32>(Min(ChunkSize, counts_[front_] - begin) * 2));
+				}
+			}
+
+			void clear() {
+				size_ = 0;
+			}
+
+		private:
+			static Buffer2D makeChunk() {
+				Buffer2D buffer;
+				buffer.vertices.resize(ChunkSize * 4, Vertex2D{ Float2::Zero(), Float2::Zero(), Float4::Zero() });
+				buffer.indices.resize(ChunkSize * 2);
+				for (size_t i = 0; i < ChunkSize; ++i) {
+					const auto base = static_cast<Vertex2D::IndexType>(i * 4);
+					buffer.indices[i * 2] = { base, static_cast<Vertex2D::IndexType>(base + 1), static_cast<Vertex2D::IndexType>(base + 2) };
+					buffer.indices[i * 2 + 1] = { static_cast<Vertex2D::IndexType>(base + 2), static_cast<Vertex2D::IndexType>(base + 1), static_cast<Vertex2D::IndexType>(base + 3) };
+				}
+				return buffer;
+			}
+		};
+	}
+}
+
+namespace Yeah {
+	//スコアの記録。ログには追記するだけで、起動時は上位の索引と、索引を書いた後に増えたログの末尾だけを読む
+	namespace Scores {
+		enum class GameId : uint16 {
+			BreakOut,
+			TenSecondsTimer,
+		};
+		struct Entry {
+			int64 rank;	//大きいほど上
+			int64 value;	//表示用の値
+			int64 time;	//記録した時刻(UNIX時間ms)
+		};
+		//ログの1件。途中で落ちて書きかけになったものはchecksumで弾く
+		struct Record {
+			uint32 checksum;
+			uint16 game;
+			uint16 mode;
+			Entry entry;
+		};
+		static_assert(sizeof(Record) == 32);
+
+		inline uint32 Checksum(const void* data, size_t size) {	//FNV-1a
+			uint32 hash = 2166136261u;
+			for (size_t i = 0; i < size; ++i) {
+				hash = (hash ^ static_cast<const uint8*>(data)[i]) * 16777619u;
+			}
+			return hash;
+		}
+		inline uint32 Checksum(const Record& record) {
+			return Checksum(reinterpret_cast<const uint8*>(&record) + sizeof(uint32), sizeof(Record) - sizeof(uint32));
+		}
+
+		//索引: "YEAHIDX1" 索引に入れたログのバイト数(uint64) 件数(uint64) 表の数(uint32)
+		//  表ごとに game(uint16) mode(uint16) 数(uint32) Entry×数
+		class Store {
+		public:
+			static constexpr size_t TopK = 10;
+			static constexpr size_t SaveInterval = 64;	//この件数ごとに索引を書き直す
+
+		private:
+			static constexpr std::array<char, 8> IndexMagic{ 'Y', 'E', 'A', 'H', 'I', 'D', 'X', '1' };
+			FilePath log_path_, index_path_, reactions_path_;	//空ならメモリ上だけ
+			HashTable<uint32, Array<Entry>> tops_;
+			ReactionStats::Book reactions_;
+			uint64 log_bytes_ = 0;
+			uint64 records_ = 0;
+			size_t unsaved_ = 0;
+			BinaryWriter writer_;
+		public:
+			Store() = default;
+			Store(FilePathView logPath, FilePathView indexPath, FilePathView reactionsPath) :
+				log_path_(logPath),
+				index_path_(indexPath),
+				reactions_path_(reactionsPath) {
+				loadIndex();
+				catchUp();
+				writer_ = BinaryWriter{ log_path_, OpenMode::Append };
+				if (not reactions_path_.isEmpty() && FileSystem::Exists(reactions_path_)
+					&& not ReactionStats::Load(reactions_path_.toUTF8(), reactions_)) {
+					//壊れているか新しい形式のファイル。上書きしないよう退避してから空で始め、退避できなければ書かない
+					std::error_code error;
+					std::filesystem::rename(std::filesystem::path(reactions_path_.toWstr()), std::filesystem::path((reactions_path_ + U".bad").toWstr()), error);
+					if (error) {
+						reactions_path_.clear();
+					}
+				}
+			}
+			~Store() {
+				if (unsaved_) {
+					saveIndex();
+				}
+			}
+
+			//記録して、上位に入ったら順位(0始まり)を返す
+			Optional<size_t> add(GameId game, uint16 mode, int64 rank, int64 value) {
+				Record record{ 0, static_cast<uint16>(game), mode, Entry{ rank, value, static_cast<int64>(Time::GetMillisecSinceEpoch()) } };
+				record.checksum = Checksum(record);
+				if (writer_) {
+					writer_.write(record);
+					writer_.flush();
+					log_bytes_ += sizeof(Record);
+					if (++unsaved_ >= SaveInterval) {
+						saveIndex();
+					}
+				}
+				return insert(record);
+			}
+			const Array<Entry>& top(GameId game, uint16 mode) const {
+				static const Array<Entry> empty;
+				const auto it = tops_.find(Key(static_cast<uint16>(game), mode));
+				return it != tops_.end() ? it->second : empty;
+			}
+			uint64 records() const {
+				return records_;
+			}
+
+			//10秒タイマーの10秒からのずれ(μs)をプレイヤーごとの統計に足す。小さいファイルなので毎回書き直す
+			const ReactionStats::Sketch& addReaction(const String& player, int64 errorMicrosec) {
+				auto& sketch = reactions_[player.toUTF8()];
+				sketch.add(errorMicrosec);
+				if (not reactions_path_.isEmpty()) {
+					ReactionStats::Save(reactions_path_.toUTF8(), reactions_);
+				}
+				return sketch;
+			}
+
+			//一時ファイルに書いてから置き換えるので、書いている途中で落ちても前の索引が残る
+			void saveIndex() {
+				if (index_path_.isEmpty()) {
+					return;
+				}
+				const FilePath temporary = index_path_ + U".tmp";
+				{
+					BinaryWriter writer{ temporary };
+					if (not writer) {
+						return;
+					}
+					writer.write(IndexMagic);
+					writer.write(log_bytes_);
+					writer.write(records_);
+					writer.write(static_cast<uint32>(tops_.size()));
+					for (const auto& [key, entries] : tops_) {
+						writer.write(static_cast<uint16>(key >> 16));
+						writer.write(static_cast<uint16>(key & 0xFFFF));
+						writer.write(static_cast<uint32>(entries.size()));
+						writer.write(entries.data(), entries.size_bytes());
+					}
+				}
+				std::error_code error;
+				std::filesystem::rename(std::filesystem::path(temporary.toWstr()), std::filesystem::path(index_path_.toWstr()), error);
+				if (not error) {
+					unsaved_ = 0;	//失敗したら次の記録でまた書く
+				}
+			}
+
+		private:
+			static uint32 Key(uint16 game, uint16 mode) {
+				return (static_cast<uint32>(game) << 16) | mode;
+			}
+			Optional<size_t> insert(const Record& record) {
+				++records_;
+				auto& entries = tops_[Key(record.game, record.mode)];
+				const auto it = std::upper_bound(entries.begin(), entries.end(), record.entry,
+					[](const Entry& a, const Entry& b) { return a.rank > b.rank; });	//同点なら先に出した方が上
+				const size_t place = static_cast<size_t>(it - entries.begin());
+				if (place >= TopK) {
+					return none;
+				}
+				entries.insert(it, record.entry);
+				if (entries.size() > TopK) {
+					entries.pop_back();
+				}
+				return place;
+			}
+
+			void loadIndex() {
+				MemoryMappedFileView view{ index_path_ };
+				if (not view) {
+					return;
+				}
+				const auto mapped = view.mapAll();
+				const Byte* p = mapped.data;
+				const Byte* const end = p + mapped.size;
+				const auto read = [&](auto& value) {
+					if (end - p < static_cast<ptrdiff_t>(sizeof(value))) {
+						return false;
+					}
+					std::memcpy(&value, p, sizeof(value));
+					p += sizeof(value);
+					return true;
+				};
+
+				std::array<char, 8> magic{};
+				uint64 logBytes = 0, records = 0;
+				uint32 tables = 0;
+				if (not read(magic) || magic != IndexMagic || not read(logBytes) || not read(records) || not read(tables)) {
+					return;	//壊れていればログから作り直す
+				}
+				HashTable<uint32, Array<Entry>> tops;
+				for (uint32 i = 0; i < tables; ++i) {
+					uint16 game = 0, mode = 0;
+					uint32 count = 0;
+					if (not read(game) || not read(mode) || not read(count) || count > TopK) {
+						return;
+					}
+					auto& entries = tops[Key(game, mode)];
+					entries.resize(count);
+					for (auto& entry : entries) {
+						if (not read(entry)) {
+							return;
+						}
+					}
+				}
+				tops_ = std::move(tops);
+				log_bytes_ = logBytes;
+				records_ = records;
+			}
+
+			//索引より後ろのログだけを読んで索引に足す。書きかけの末尾は切り落とす
+			void catchUp() {
+				const int64 size = FileSystem::FileSize(log_path_);
+				if (size < static_cast<int64>(log_bytes_)) {	//ログが差し替えられた
+					tops_.clear();
+					log_bytes_ = records_ = 0;
+				}
+				uint64 valid = log_bytes_;
+				if (size > static_cast<int64>(log_bytes_)) {
+					constexpr uint64 Granularity = 64 << 10;	//マップする位置は割り当て単位に揃える
+					const uint64 base = log_bytes_ / Granularity * Granularity;
+					MemoryMappedFileView view{ log_path_ };
+					if (view) {
+						const auto mapped = view.map(base, static_cast<size_t>(size - base));
+						for (uint64 offset = log_bytes_ - base; offset + sizeof(Record) <= mapped.size; offset += sizeof(Record)) {
+							Record record;
+							std::memcpy(&record, mapped.data + offset, sizeof(Record));
+							if (record.checksum != Checksum(record)) {
+								break;
+							}
+							insert(record);
+							valid = base + offset + sizeof(Record);
+						}
+					}
+				}
+				if (static_cast<int64>(valid) < size) {
+					std::error_code error;
+					std::filesystem::resize_file(std::filesystem::path(log_path_.toWstr()), valid, error);
+				}
+				if (valid != log_bytes_) {
+					log_bytes_ = valid;
+					saveIndex();
+				}
+			}
+		};
+
+		//Openしなければメモリ上だけに記録する(ヘッドレス・再生用)
+		inline std::unique_ptr<Store>& Instance() {
+			static std::unique_ptr<Store> store = std::make_unique<Store>();
+			return store;
+		}
+		inline void Open(FilePathView logPath, FilePathView indexPath, FilePathView reactionsPath) {
+			Instance() = std::make_unique<Store>(logPath, indexPath, reactionsPath);
+		}
+		inline Store& Get() {
+			return *Instance();
+		}
+		//プレイヤーはOSのユーザー名で分ける
+		inline const String& PlayerName() {
+			static const String name = [] {
+				for (const auto& variable : { U"USERNAME", U"USER" }) {
+					if (String value = EnvironmentVariable::Get(variable); not value.isEmpty()) {
+						return value;
+					}
+				}
+				return String{ U"player" };
+			}();
+			return name;
+		}
+	}
+}
+
+namespace Yeah {
+	//プレイ画面の録画。フレームを使い回しのバッファに写してキューに積み、エンコードと書き込みは専用のスレッドで行う
+	//バッファが空いていなければそのフレームは捨てて、ゲームは待たせない
+	namespace Capture {
+		enum class Format {
+			QOI,	//連番。軽いので取りこぼしにくい
+			PNG,	//連番
+			GIF,	//1ファイル。2フレームに1枚
+		};
+		inline StringView ToString(Format format) {
+			switch (format) {
+			case Format::QOI: return U"qoi";
+			case Format::PNG: return U"png";
+			case Format::GIF: return U"gif";
+			}
+			return U"";
+		}
+
+		//QOI(Quite OK Image Format)で書く。PNGより圧縮は弱いが桁違いに速い
+		inline bool SaveQOI(const Image& image, FilePathView path) {
+			Array<uint8> out;
+			out.reserve(14 + image.num_pixels() * 2);
+			const auto put32 = [&](uint32 v) {
+				out << static_cast<uint8>(v >> 24) << static_cast<uint8>(v >> 16) << static_cast<uint8>(v >> 8) << static_cast<uint8>(v);
+			};
+			out << 'q' << 'o' << 'i' << 'f';
+			put32(image.width());
+			put32(image.height());
+			out << 4 << 0;	//RGBA, sRGB
+
+			std::array<Color, 64> index{};
+			Color prev{ 0, 0, 0, 255 };
+			uint8 run = 0;
+			for (const Color& px : image) {
+				if (px == prev) {
+					if (++run == 62) {
+						out << static_cast<uint8>(0xC0 | (run - 1));
+						run = 0;
+					}
+					continue;
+				}
+				if (run > 0) {
+					out << static_cast<uint8>(0xC0 | (run - 1));
+					run = 0;
+				}
+				const size_t hash = (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+				if (index[hash] == px) {
+					out << static_cast<uint8>(hash);
+					prev = px;
+					continue;
+				}
+				index[hash] = px;
+				if (px.a == prev.a) {
+					const int32 dr = static_cast<int8>(px.r - prev.r), dg = static_cast<int8>(px.g - prev.g), db = static_cast<int8>(px.b - prev.b);
+					const int32 dr_dg = dr - dg, db_dg = db - dg;
+					if (-2 <= dr && dr <= 1 && -2 <= dg && dg <= 1 && -2 <= db && db <= 1) {
+						out << static_cast<uint8>(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+					}
+					else if (-32 <= dg && dg <= 31 && -8 <= dr_dg && dr_dg <= 7 && -8 <= db_dg && db_dg <= 7) {
+						out << static_cast<uint8>(0x80 | (dg + 32)) << static_cast<uint8>((dr_dg + 8) << 4 | (db_dg + 8));
+					}
+					else {
+						out << 0xFE << px.r << px.g << px.b;
+					}
+				}
+				else {
+					out << 0xFF << px.r << px.g << px.b << px.a;
+				}
+				prev = px;
+			}
+			if (run > 0) {
+				out << static_cast<uint8>(0xC0 | (run - 1));
+			}
+			out << 0 << 0 << 0 << 0 << 0 << 0 << 0 << 1;
+
+			BinaryWriter writer{ path };
+			return writer && writer.write(out.data(), out.size_bytes()) == static_cast<int64>(out.size_bytes());
+		}
+
+		class Recorder {
+			static constexpr size_t PoolSize = 8;	//キューの長さの上限も兼ねる
+			struct Item {
+				enum class Kind { Frame, Still, End } kind;
+				Image image;
+				FilePath path;	//Frameでは連番のファイル名かGIFのファイル名
+				Format format = Format::PNG;
+			};
+
+			std::mutex mutex_;
+			std::condition_variable wake_;
+			Array<Image> free_;	//空いているバッファ
+			std::deque<Item> queue_;
+			bool stop_ = false;
+			std::atomic<uint64> written_{ 0 }, dropped_{ 0 }, failed_{ 0 };
+
+			//以下はメインスレッドだけが触る
+			Optional<Format> format_;
+			FilePath directory_;
+			uint64 frame_ = 0;
+
+			std::thread thread_;	//最後に作る
+		public:
+			Recorder() :
+				free_(PoolSize),
+				thread_([this]() { run(); }) {}
+			~Recorder() {
+				stop();
+				{
+					std::lock_guard lock(mutex_);
+					stop_ = true;
+				}
+				wake_.notify_one();
+				thread_.join();	//積んだ分は書き終えてから止まる
+			}
+			Recorder(const Recorder&) = delete;
+			Recorder& operator=(const Recorder&) = delete;
+
+			void start(Format format, FilePathView directory) {
+				stop();
+				format_ = format;
+				directory_ = U"{}/{}/"_fmt(directory, DateTime::Now().format(U"yyyyMMdd-HHmmss"));
+				FileSystem::CreateDirectories(directory_);
+				frame_ = 0;
+				ScreenCapture::RequestCurrentFrame();
+			}
+			void stop() {
+				if (not format_) {
+					return;
+				}
+				if (*format_ == Format::GIF) {
+					push(Item{ Item::Kind::End });	//GIFを閉じる。捨てないようバッファは使わない
+				}
+				format_.reset();
+			}
+			bool isRecording() const {
+				return format_.has_value();
+			}
+			Optional<Format> format() const {
+				return format_;
+			}
+			uint64 frames() const { return frame_; }
+			uint64 written() const { return written_; }
+			uint64 dropped() const { return dropped_; }
+			uint64 failed() const { return failed_; }	//書き込みに失敗した数
+
+			//System::Updateの後に毎フレーム呼ぶ。前のフレームの画面が届いていれば積み、次を頼む
+			void update() {
+				if (not format_) {
+					return;
+				}
+				if (ScreenCapture::HasNewFrame()) {
+					const Image& screen = ScreenCapture::GetFrame();
+					if (*format_ != Format::GIF || frame_ % 2 == 0) {
+						const FilePath path = (*format_ == Format::GIF)
+							? directory_ + U"capture.gif"
+							: directory_ + U"{:06d}.{}"_fmt(frame_, ToString(*format_));
+						submitCopy(screen, Item::Kind::Frame, path, *format_);
+					}
+					++frame_;
+				}
+				ScreenCapture::RequestCurrentFrame();
+			}
+			//画面を通さずに作った画像を書く。形式は拡張子で決める
+			//頼まれて撮るものなので録画のバッファは使わず、録画が詰まっていても捨てない
+			void submit(Image&& image, FilePathView path) {
+				const Format format = (FileSystem::Extension(path) == U"qoi") ? Format::QOI : Format::PNG;
+				push(Item{ Item::Kind::Still, std::move(image), FilePath{ path }, format });
+			}
+
+		private:
+			//空いているバッファに写して積む。空いていなければ捨ててfalse
+			bool submitCopy(const Image& image, Item::Kind kind, FilePath path, Format format) {
+				Image buffer;
+				{
+					std::lock_guard lock(mutex_);
+					if (free_.isEmpty()) {
+						++dropped_;
+						return false;
+					}
+					buffer = std::move(free_.back());
+					free_.pop_back();
+				}
+				buffer = image;	//前に使ったときの確保をそのまま使う
+				push(Item{ kind, std::move(buffer), std::move(path), format });
+				return true;
+			}
+			void push(Item&& item) {
+				{
+					std::lock_guard lock(mutex_);
+					queue_.push_back(std::move(item));
+				}
+				wake_.notify_one();
+			}
+
+			void run() {
+				Optional<AnimatedGIFWriter> gif;
+				for (;;) {
+					Item item;
+					{
+						std::unique_lock lock(mutex_);
+						wake_.wait(lock, [this]() { return stop_ || not queue_.empty(); });
+						if (queue_.empty()) {
+							return;
+						}
+						item = std::move(queue_.front());
+						queue_.pop_front();
+					}
+					if (item.kind == Item::Kind::End) {
+						if (gif) {
+							gif->close();
+							gif.reset();
+						}
+						continue;
+					}
+					bool ok = false;
+					if (item.kind == Item::Kind::Frame && item.format == Format::GIF) {
+						if (not gif) {
+							gif.emplace(item.path, item.image.size());
+						}
+						ok = gif->writeFrame(item.image, SecondsF{ 2 / 60.0 });	//2フレームに1枚
+					}
+					else if (item.format == Format::QOI) {
+						ok = SaveQOI(item.image, item.path);
+					}
+					else {
+						ok = item.image.savePNG(item.path);
+					}
+					++(ok ? written_ : failed_);
+					if (item.kind == Item::Kind::Frame) {
+						std::lock_guard lock(mutex_);
+						free_ << std::move(item.image);
+					}
+				}
+			}
+		};
+
+		inline std::unique_ptr<Recorder>& Instance() {
+			static std::unique_ptr<Recorder> recorder;
+			return recorder;
+		}
+		inline Recorder& Get() {
+			if (not Instance()) {
+				Instance() = std::make_unique<Recorder>();
+			}
+			return *Instance();
+		}
+	}
+}
+
+/*シーンの前方宣言*/
+namespace Master {
+	class Title;
+}
+namespace Second {
+	class Title;
+}
+namespace ConwaysGameOfLife {
+	class Title;
+	class Game;
+}
+namespace BreakOut {
+	class Title;
+	class Game;
+	class Game2;
+	class Result;
+}
+namespace FindShape {
+	class Title;
+	class GameScene1;
+	class GameScene2;
+	class Result;
+	class Answer;
+}
+namespace TenSecondsTimer {
+	class Title;
+	class Rule;
+	class Game;
+	class Result;
+}
+
+/*シーン実装*/
+namespace Master {
+	class Title :public Yeah::Scenes::IScene {
+		const Yeah::Assets::StaticText title_{ 100, U"MiniGames" };
+	public:
+		static constexpr StringView SessionName = U"master.title";
+		void update() override {
+			if (Yeah::GUI::ButtonAt(U"ライフゲーム", { 400,350 }, 200)) {
+				changeScene(SceneFactory::CreateAsync<ConwaysGameOfLife::Title>(), 0.4s, 0.4s);
+			}
+			if (Yeah::GUI::ButtonAt(U"ブロック崩し", { 400,400 }, 200)) {
+				changeScene(SceneFactory::CreateAsync<BreakOut::Title>(), 0.4s, 0.4s);
+			}
+			if (Yeah::GUI::ButtonAt(U"供養ゲーム", { 400,450 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Second::Title>(),
+					TransitionFactory::Create<Yeah::Transitions::CustomFadeInOut<Yeah::Transitions::AlphaFadeOut, Yeah::Transitions::AlphaFadeIn>>(0.4s, 0.4s)
+				);
+			}
+			if (Yeah::GUI::ButtonAt(U"終了", { 400,500 }, 200)) {
+				exit();
+			}
+		}
+		void draw() const override {
+			title_.drawAt({ 400,180 });
+		}
+	};
+}
+namespace Second {
+	class Title :public Yeah::Scenes::IScene {
+		const Yeah::Assets::StaticText title_{ 100, U"MiniGames" };
+	public:
+		static constexpr StringView SessionName = U"second.title";
+		void update() override {
+			if (Yeah::GUI::ButtonAt(U"図形探し", { 400,350 }, 200)) {
+				changeScene(
+					SceneFactory::Create<FindShape::Title>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+			if (Yeah::GUI::ButtonAt(U"10秒タイマー", { 400,400 }, 200, true)) {
+				changeScene(
+					SceneFactory::Create<TenSecondsTimer::Title>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+			if (Yeah::GUI::ButtonAt(U"", { 400,450 }, 200, false)) {
+			}
+			if (Yeah::GUI::ButtonAt(U"戻る", { 400,500 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Master::Title>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+		}
+		void draw() const override {
+			title_.drawAt({ 400,180 });
+		}
+	};
+}
+namespace ConwaysGameOfLife {
+	class Impl {	//ライフゲーム本体
+	public:
+		Grid<bool> cell_;
+
+		Impl(const Size& size, bool value = false) :
+			cell_(size, value) {}
+		void update() {
+			Grid<bool> tmp(cell_.size());
+			//行ごとに分けて並列に数える。小さい盤面は1チャンクに収まってその場で回る
+			const size_t rows = Max<size_t>(4096 / Max<size_t>(cell_.width(), 1), 1);
+			Yeah::Jobs::ParallelFor(0, cell_.height(), rows, [&](size_t begin, size_t end) {
+				for (int32 y = static_cast<int32>(begin); y < static_cast<int32>(end); ++y) {
+					for (int32 x = 0; x < cell_.width(); ++x) {
+						int32 countAround = 0;
+						for (const auto& i : step(Point(-1, -1), Size(3, 3))) {
+							if (i.isZero()) {
+								continue;
+							}
+							countAround += cell_.fetch(Point(x, y) + i, false);
+						}
+						tmp[y][x] = (countAround == 3) || (countAround == 2 && cell_[y][x]);
+					}
+				}
+			});
+			cell_ = std::move(tmp);
+		}
+		void draw() const {
+			for (const auto& p : step(cell_.size())) {
+				RectF(p, 1).draw(cell_[p] ? Palette::Yellow : Palette::Gray).drawFrame(0.05, 0.0, Palette::Black);
+			}
+		}
+		//画面を通さずに盤面を画像にする。1マスcellSizeピクセルで、4以上なら枠線も描く
+		Image toImage(int32 cellSize) const {
+			Image image(cell_.size() * cellSize);
+			const bool frame = cellSize >= 4;
+			for (int32 y = 0; y < image.height(); ++y) {
+				Color* row = image[y];
+				const int32 cy = y % cellSize;
+				for (int32 x = 0; x < image.width(); ++x) {
+					const int32 cx = x % cellSize;
+					if (frame && (cx == 0 || cy == 0 || cx == cellSize - 1 || cy == cellSize - 1)) {
+						row[x] = Palette::Black;
+					}
+					else {
+						row[x] = cell_[y / cellSize][x / cellSize] ? Palette::Yellow : Palette::Gray;
+					}
+				}
+			}
+			return image;
+		}
+		size_t memoryUsage() const {
+			return Yeah::Memory::Estimate(cell_);
+		}
+		uint32 checksum() const {
+			return Yeah::Scenes::Checksum{}.add(cell_.size()).bytes(cell_.data(), cell_.num_elements()).value();
+		}
+
+		//1マス1ビットに詰める
+		void save(Yeah::Session::Writer& writer) const {
+			Array<uint64> words((cell_.num_elements() + 63) / 64, 0);
+			const bool* cells = cell_.data();
+			for (size_t i = 0; i < cell_.num_elements(); ++i) {
+				words[i / 64] |= static_cast<uint64>(cells[i]) << (i % 64);
+			}
+			writer.write(cell_.size());
+			writer.writeArray(words);
+		}
+		void restore(Yeah::Session::Reader& reader) {
+			const Size size = reader.read<Size>();
+			const Array<uint64> words = reader.readArray<uint64>();
+			if (size.x < 0 || size.y < 0 || words.size() != (static_cast<size_t>(size.x) * size.y + 63) / 64) {
+				return;	//壊れていれば今の盤面のまま
+			}
+			cell_ = Grid<bool>(size);
+			bool* cells = cell_.data();
+			for (size_t i = 0; i < cell_.num_elements(); ++i) {
+				cells[i] = (words[i / 64] >> (i % 64)) & 1;
+			}
+		}
+	};
+
+	class Title :public Yeah::Scenes::IScene {
+		Impl impl_{ Size(40,30) };
+		Timer timer{ 2s, StartImmediately::Yes, Yeah::Inputs::Clock() };
+		const Yeah::Assets::StaticText title_{ 100, U"ライフゲーム" };
+	public:
+		static constexpr StringView SessionName = U"life.title";
+		Title() {
+			for (auto&& i : impl_.cell_) {
+				i = RandomBool(0.3);
+			}
+		}
+		void update() override {
+			impl_.update();
+			if (timer.reachedZero()) {
+				for (auto&& i : impl_.cell_) {
+					i = RandomBool(0.3);
+				}
+				timer.restart();
+			}
+
+			//フェード中に背景のライフゲームを回さないように画像にして消す。ボタンはdrawで描く
+			if (Yeah::GUI::ClickedAt(U"スタート", { 400,400 }, 200)) {
+				changeScene(SceneFactory::CreateAsync<Game>(), 0.4s, 0.4s, true);
+			}
+			if (Yeah::GUI::ClickedAt(U"戻る", { 400,450 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Master::Title>(),
+					TransitionFactory::Create<Yeah::Transitions::FrozenOut<Yeah::Transitions::AlphaFadeInOut>>(0.4s, 0.4s)
+				);
+			}
+		}
+		void draw() const override {
+			{
+				const Transformer2D t(Mat3x2::Translate(-10, -7.5).scaled(40));
+				const ScopedColorMul2D s(1.0, 0.1);
+				impl_.draw();
+			}
+			title_.drawAt({ 400,180 });
+			Yeah::GUI::DrawButtonAt(U"スタート", { 400,400 }, 200);
+			Yeah::GUI::DrawButtonAt(U"戻る", { 400,450 }, 200);
+		}
+		bool freezable() const override { return true; }
+		void load() override {
+			title_.prepare();
+		}
+		size_t memoryUsage() const override {
+			return impl_.memoryUsage();
+		}
+	};
+	class Game :public Yeah::Scenes::IScene {
+		Impl impl_{ Size(30,30) };
+		//drawが読む盤面。オートの世代交代はsimulateで進めてpublishで写す
+		//セッションの書き出しはこれを共有して裏で詰めるので、その間はpublishで新しく作る
+		std::shared_ptr<Impl> shown_ = std::make_shared<Impl>(impl_);
+		bool auto_ = false;
+	public:
+		static constexpr StringView SessionName = U"life.game";
+		Game() = default;
+		explicit Game(Yeah::Session::Reader& reader) {
+			impl_.restore(reader);
+			auto_ = reader.read<bool>();
+			*shown_ = impl_;
+		}
+		//simulateと並行に呼ばれるので、publishで写した方を残す。盤面は共有して、詰めるのは書き出しのワーカー
+		void save(Yeah::Session::Writer& writer) const override {
+			writer.defer([board = std::shared_ptr<const Impl>(shown_)](Yeah::Session::Writer& w) { board->save(w); });
+			writer.write(auto_);
+		}
+		void update() override {
+			const Vec2 cursor = Yeah::Inputs::CursorPos() / 20;
+			if (const Point p{ static_cast<int32>(Floor(cursor.x)), static_cast<int32>(Floor(cursor.y)) }; impl_.cell_.inBounds(p)) {
+				if (Yeah::Inputs::MouseL.pressed()) {
+					impl_.cell_[p] = true;
+				}
+				else if (Yeah::Inputs::Key(MouseR).pressed()) {
+					impl_.cell_[p] = false;
+				}
+			}
+
+			if (Yeah::GUI::ButtonAt(U"次へ", { 700,50 }, 160, not auto_)) {
+				impl_.update();
+			}
+			Yeah::GUI::CheckBoxAt(auto_, U"オート", { 700,100 }, 160);
+			if (Yeah::GUI::ButtonAt(U"ランダム", { 700,200 }, 160)) {
+				const double chance = Random(0.1, 0.5);
+				for (auto&& i : impl_.cell_) {
+					i = RandomBool(chance);
+				}
+			}
+			if (Yeah::GUI::ButtonAt(U"リセット", { 700,250 }, 160)) {
+				impl_.cell_.fill(false);
+			}
+			if (Yeah::GUI::ButtonAt(U"画像で保存", { 700,300 }, 160)) {
+				FileSystem::CreateDirectories(U"captures/");
+				Yeah::Capture::Get().submit(shown_->toImage(20), U"captures/life-{}.png"_fmt(DateTime::Now().format(U"yyyyMMdd-HHmmss-SS")));
+			}
+
+			if (Yeah::GUI::ButtonAt(U"戻る", { 700,550 }, 160) || Yeah::Inputs::Key(KeyB).down()) {
+				undo(TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s));
+			}
+		}
+		bool pipelined() const override { return true; }
+		void simulate() override {
+			if (auto_) {
+				impl_.update();
+			}
+		}
+		void publish() override {
+			if (shown_.use_count() > 1) {	//書き出しがまだ前の盤面を持っている
+				shown_ = std::make_shared<Impl>(impl_);
+			}
+			else {
+				shown_->cell_ = impl_.cell_;
+			}
+		}
+		void draw() const override {
+			const Transformer2D t(Mat3x2::Scale(20), true);
+			shown_->draw();
+		}
+		size_t memoryUsage() const override {
+			return impl_.memoryUsage() + shown_->memoryUsage();
+		}
+		//impl_はsimulateが書いているので、publishで写した方を見る
+		uint32 checksum() const override {
+			return shown_->checksum();
+		}
+	};
+}
+namespace BreakOut {
+	class Impl {	//ゲーム本体の実装
+	public:
+		struct Block {
+			RectF region;
+			ColorF color;
+			int32 life;
+
+			void draw() const {
+				region.stretched(-1).draw(color);
+			}
+		};
+		Size block_size_{ 40,25 };
+		Size blocks_num_{ 16,7 };
+		static constexpr Point blocks_center{ 400,150 };
+		double ball_speed = 400.0;
+		Array<Block> blocks_;
+		Vec2 ball_vel_ = Vec2::Zero();
+		Circle ball_{ 0,0,8 };
+		RectF paddle_{ 0,0,60,10 };
+		int32 score_ = 0;
+		Stopwatch sw{ StartImmediately::No, Yeah::Inputs::Clock() };
+		Yeah::Effects::ParticleSystem particles_;	//ブロック破壊エフェクト
+
+		bool hold = true;
+
+		Impl(const Size& block_size, const Size& blocks_num, size_t particle_capacity = 0):
+			block_size_(block_size),
+			blocks_num_(blocks_num),
+			particles_(particle_capacity) {
+			for (const auto& i : step(blocks_num_)) {
+				blocks_ << Block{ RectF(Arg::center = blocks_center - (i - (blocks_num_ - Vec2::One()) / 2.0) * block_size_,block_size_),RandomColorF(),1 };
+			}
+		}
+
+		bool update() {
+			paddle_.setPos(Arg::center = Vec2{ Yeah::Inputs::CursorPos().x, 500 });
+
+			if (hold && Yeah::Inputs::MouseL.down()) {
+				hold = false;
+				ball_vel_ = Vec2::Up(ball_speed);
+				sw.start();
+			}
+
+			if (hold) {
+				ball_.setPos(Arg::bottomCenter = paddle_.topCenter());
+				ball_vel_ = Vec2::Zero();
+			}
+			else {
+				ball_.moveBy(ball_vel_ * Yeah::Inputs::DeltaTime());
+			}
+
+			for (auto i = begin(blocks_); i != end(blocks_); ++i) {
+				if (i->region.intersects(ball_)) {
+					if (i->region.right().intersects(ball_) || i->region.left().intersects(ball_)) {
+						ball_vel_.x *= -1;
+					}
+					if (i->region.top().intersects(ball_) || i->region.bottom().intersects(ball_)) {
+						ball_vel_.y *= -1;
+					}
+
+					if (--(i->life) <= 0) {
+						particles_.emit(i->region.center(), i->color, 48, 240.0);
+						blocks_.erase(i);
+						++score_;
+						ball_speed += 5;
+					}
+					break;
+				}
+			}
+
+			if ((ball_.x < 0 && ball_vel_.x < 0) || (800 < ball_.x && ball_vel_.x > 0)) {
+				ball_vel_.x *= -1;
+			}
+			if (ball_.y < 0 && ball_vel_.y < 0) {
+				ball_vel_.y *= -1;
+			}
+			if (ball_vel_.y > 0 && paddle_.intersects(ball_)) {
+				ball_vel_ = Vec2((ball_.x - paddle_.center().x) * 10, -ball_vel_.y).setLength(ball_speed);
+			}
+
+			ball_vel_.setLength(ball_speed);
+
+			if (ball_.y > 600) {
+				return false;
+			}
+			if (blocks_.empty()) {
+				return false;
+			}
+
+			return true;
+		}
+		//パーティクルはブロックやボールと関わらないので、描画と並行して進める
+		void simulate(double deltaTime) {
+			particles_.update(deltaTime);
+			particles_.prepare();
+		}
+		void publish() {
+			particles_.publish();
+		}
+		void draw() const {
+			for (const auto& i : blocks_) {
+				i.draw();
+			}
+			particles_.draw();
+			ball_.draw();
+			paddle_.draw();
+		}
+		size_t memoryUsage() const {
+			return blocks_.capacity() * sizeof(Block) + particles_.memoryUsage();
+		}
+		//パーティクルはsimulateが動かすので入れない
+		uint32 checksum() const {
+			Yeah::Scenes::Checksum checksum;
+			checksum.add(ball_).add(ball_vel_).add(ball_speed).add(score_).add(hold).add(blocks_.size());
+			for (const auto& block : blocks_) {
+				checksum.add(block.region).add(block.life);
+			}
+			return checksum.value();
+		}
+
+		//パーティクルは残さない
+		void save(Yeah::Session::Writer& writer) const {
+			writer.writeArray(blocks_);
+			writer.write(ball_);
+			writer.write(ball_vel_);
+			writer.write(ball_speed);
+			writer.write(score_);
+			writer.write(hold);
+			writer.write(sw.elapsed());
+		}
+		void restore(Yeah::Session::Reader& reader) {
+			blocks_ = reader.readArray<Block>();
+			ball_ = reader.read<Circle>();
+			ball_vel_ = reader.read<Vec2>();
+			ball_speed = reader.read<double>();
+			score_ = reader.read<int32>();
+			hold = reader.read<bool>();
+			if (const Duration elapsed = reader.read<Duration>(); not hold) {
+				sw.set(elapsed);
+				sw.resume();	//setは一時停止を解かない
+			}
+		}
+	};
+
+	class Title :public Yeah::Scenes::IScene {
+		const Yeah::Assets::StaticText title_{ 100, U"ブロック崩し" };
+		Impl impl_{ {40,25},{16,7} };
+	public:
+		static constexpr StringView SessionName = U"breakout.title";
+		void update() override {
+			if (Yeah::GUI::ButtonAt(U"スタート", { 400,350 }, 200)) {
+				changeScene(SceneFactory::CreateAsync<Game>(), 0.4s, 0.4s);
+			}
+			{
+				const ScopedColorMul2D s(1.0, 0.0);
+				if (Yeah::GUI::ButtonAt(U"ハード", { 400,400 }, 200)) {
+					changeScene(SceneFactory::CreateAsync<Game2>(), 0.4s, 0.4s);
+				}
+			}
+			if (Yeah::GUI::ButtonAt(U"戻る", { 400,450 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Master::Title>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+		}
+		void draw() const override {
+			{
+				const Transformer2D t(Mat3x2::Translate(0, 150).scaled(3, {400,150}));
+				const ScopedColorMul2D s(1.0, 0.1);
+				impl_.draw();
+			}
+			title_.drawAt({ 400,180 }, Palette::White);
+		}
+		void load() override {
+			title_.prepare();
+		}
+		size_t memoryUsage() const override {
+			return impl_.memoryUsage();
+		}
+	};
+	class Game :public Yeah::Scenes::IScene {
+		static constexpr uint16 Mode = 0;
+		Impl impl_{ {40,25},{16,7},100'000 };
+		double delta_time_ = 0.0;	//simulate用。Inputsはワーカーから読めない
+		bool finished_ = false;
+	public:
+		static constexpr StringView SessionName = U"breakout.game";
+		Game() = default;
+		explicit Game(Yeah::Session::Reader& reader) {
+			if (not reader.read<bool>()) {	//終わっていたものは新しく始める
+				impl_.restore(reader);
+			}
+		}
+		void save(Yeah::Session::Writer& writer) const override {
+			writer.write(finished_);
+			if (not finished_) {
+				impl_.save(writer);
+			}
+		}
+		void update() override {
+			delta_time_ = Yeah::Inputs::DeltaTime();
+			if (not impl_.update() && not finished_) {
+				finished_ = true;	//フェードアウト中も呼ばれるので一度だけ記録する
+				const auto place = Yeah::Scores::Get().add(Yeah::Scores::GameId::BreakOut, Mode, impl_.score_, impl_.score_);
+				changeScene(
+					SceneFactory::Create<Result>(impl_.score_, impl_.sw.elapsed(), SceneFactory::Create<Game>, Mode, place),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+		}
+		bool pipelined() const override { return true; }
+		void simulate() override {
+			impl_.simulate(delta_time_);
+		}
+		void publish() override {
+			impl_.publish();
+		}
+		void draw() const override {
+			impl_.draw();
+		}
+		size_t memoryUsage() const override {
+			return impl_.memoryUsage();
+		}
+		uint32 checksum() const override {
+			return impl_.checksum();
+		}
+	};
+	class Game2 :public Yeah::Scenes::IScene {
+		static constexpr uint16 Mode = 1;
+		Impl impl_{ {20,10},{35,20},100'000 };
+		double delta_time_ = 0.0;	//simulate用。Inputsはワーカーから読めない
+		bool finished_ = false;
+	public:
+		static constexpr StringView SessionName = U"breakout.game2";
+		Game2() = default;
+		explicit Game2(Yeah::Session::Reader& reader) {
+			if (not reader.read<bool>()) {	//終わっていたものは新しく始める
+				impl_.restore(reader);
+			}
+		}
+		void save(Yeah::Session::Writer& writer) const override {
+			writer.write(finished_);
+			if (not finished_) {
+				impl_.save(writer);
+			}
+		}
+		void update() override {
+			delta_time_ = Yeah::Inputs::DeltaTime();
+			if (not impl_.update() && not finished_) {
+				finished_ = true;	//フェードアウト中も呼ばれるので一度だけ記録する
+				const auto place = Yeah::Scores::Get().add(Yeah::Scores::GameId::BreakOut, Mode, impl_.score_, impl_.score_);
+				changeScene(
+					SceneFactory::Create<Result>(impl_.score_, impl_.sw.elapsed(), SceneFactory::Create<Game2>, Mode, place),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+		}
+		bool pipelined() const override { return true; }
+		void simulate() override {
+			impl_.simulate(delta_time_);
+		}
+		void publish() override {
+			impl_.publish();
+		}
+		void draw() const override {
+			impl_.draw();
+		}
+		size_t memoryUsage() const override {
+			return impl_.memoryUsage();
+		}
+		uint32 checksum() const override {
+			return impl_.checksum();
+		}
+	};
+
+	class Result :public Yeah::Scenes::IScene {
+		const Yeah::Assets::FontRef font{ 100 }, font50{ 50 }, font20{ 20 };
+		int32 score_;
+		Duration duration_;
+		std::unique_ptr<Yeah::Scenes::IScene>(*factory_)();
+		uint16 mode_;
+		Optional<size_t> place_;	//ランキングに入ったときの順位
+	public:
+		Result(int32 score, const Duration& duration, std::unique_ptr<Yeah::Scenes::IScene>(*factory)(), uint16 mode, const Optional<size_t>& place) :
+			score_(score),
+			duration_(duration),
+			factory_(factory),
+			mode_(mode),
+			place_(place) {}
+		void update() override {
+			if (Yeah::GUI::ButtonAt(U"もう一度", { 400,450 }, 200)) {
+				changeScene(
+					factory_(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+			if (Yeah::GUI::ButtonAt(U"戻る", { 400,500 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Title>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+		}
+		void draw() const override {
+			font(U"スコア:{}"_fmt(score_)).drawAt({ 400,180 });
+			font(U"タイム:{:.2f}s"_fmt(duration_.count())).drawAt({ 400,300 });
+			if (place_) {
+				font50(U"ランキング {}位！"_fmt(*place_ + 1)).drawAt({ 400,390 }, Palette::Yellow);
+			}
+			if (const auto& top = Yeah::Scores::Get().top(Yeah::Scores::GameId::BreakOut, mode_); not top.isEmpty()) {
+				font20(U"ベスト {}"_fmt(top.front().value)).drawAt({ 400,550 });
+			}
+		}
+	};
+}
+namespace FindShape {
+	class Title :public Yeah::Scenes::IScene {
+		const Yeah::Assets::StaticText title_{ 100, U"図形を探せ！" };
+	public:
+		static constexpr StringView SessionName = U"findshape.title";
+		void update() override {
+			if (Yeah::GUI::ButtonAt(U"イージー", { 400,350 }, 200)) {
+				changeScene(
+					SceneFactory::Create<GameScene1>(50, Placement{ 1.0,0.2 }),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+			if (Yeah::GUI::ButtonAt(U"ノーマル", { 400,400 }, 200)) {
+				changeScene(
+					SceneFactory::Create<GameScene1>(100, Placement{ 0.8,0.4 }),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+			if (Yeah::GUI::ButtonAt(U"ハード", { 400,450 }, 200)) {
+				changeScene(
+					SceneFactory::Create<GameScene1>(200, Placement{ 0.5,0.6 }),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+			if (Yeah::GUI::ButtonAt(U"エクストリーム", { 400,500 }, 200)) {
+				changeScene(
+					SceneFactory::Create<GameScene1>(50000, Placement{ 1.0,0.6 }),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+			if (Yeah::GUI::ButtonAt(U"戻る", { 400,550 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Second::Title>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+		}
+		void draw() const override {
+			title_.drawAt({ 400,180 });
+		}
+	};
+
+	struct Shape {
+		Polygon polygon;
+		ColorF color;
+	};
+
+	//図形のバウンディングボックスを一様グリッドに登録し、カーソル直下の候補だけを調べる
+	class ShapeIndex {
+		static constexpr double CellSize = 40.0;
+		static constexpr Size CellsNum{ 20,15 };	//800x600を覆う。はみ出した図形は端のセルに入れる
+
+		Grid<Array<int32>> cells_{ CellsNum };	//各セルの中身は描画順(添字)の昇順
+		Array<Rect> ranges_;	//各図形が登録されているセル範囲
+	public:
+		void build(const Array<Shape>& shapes) {
+			for (auto&& cell : cells_) {
+				cell.clear();
+			}
+			ranges_.resize(shapes.size());
+			for (const auto& [i, s] : Indexed(shapes)) {
+				ranges_[i] = cellRange(s.polygon.boundingRect());
+				for (const auto& p : step(ranges_[i].pos, ranges_[i].size)) {
+					cells_[p] << static_cast<int32>(i);
+				}
+			}
+		}
+
+		//図形が動いたときに登録し直す
+		void update(const Array<Shape>& shapes, int32 index) {
+			const Rect range = cellRange(shapes[index].polygon.boundingRect());
+			if (range == ranges_[index]) {
+				return;
+			}
+			for (const auto& p : step(ranges_[index].pos, ranges_[index].size)) {
+				auto& cell = cells_[p];
+				if (const auto it = std::lower_bound(cell.begin(), cell.end(), index); it != cell.end() && *it == index) {
+					cell.erase(it);
+				}
+			}
+			for (const auto& p : step(range.pos, range.size)) {
+				auto& cell = cells_[p];
+				cell.insert(std::lower_bound(cell.begin(), cell.end(), index), index);
+			}
+			ranges_[index] = range;
+		}
+
+		//posの上で一番手前にある図形
+		Optional<int32> topmostAt(const Array<Shape>& shapes, const Vec2& pos) const {
+			const auto& cell = cells_[cellAt(pos)];
+			for (auto it = cell.rbegin(); it != cell.rend(); ++it) {
+				const auto& polygon = shapes[*it].polygon;
+				if (polygon.boundingRect().intersects(pos) && polygon.intersects(pos)) {
+					return *it;
+				}
+			}
+			return none;
+		}
+
+	private:
+		static Point cellAt(const Vec2& pos) {
+			return {
+				Clamp(static_cast<int32>(Floor(pos.x / CellSize)), 0, CellsNum.x - 1),
+				Clamp(static_cast<int32>(Floor(pos.y / CellSize)), 0, CellsNum.y - 1)
+			};
+		}
+		static Rect cellRange(const RectF& rect) {
+			const Point tl = cellAt(rect.tl()), br = cellAt(rect.br());
+			return Rect(tl, br - tl + Point(1, 1));
+		}
+	};
+
+	//全図形を一度だけ三角形分割して共有の頂点バッファにまとめる。影と塗りは同じメッシュを使い回す
+	class ShapeMesh {
+		static constexpr size_t MaxVertices = 65536;	//Vertex2D::IndexTypeがuint16なので1チャンクあたりの上限
+		struct Range {
+			uint32 chunk;
+			uint32 vertex_begin;
+		};
+		Array<Buffer2D> chunks_;
+		Array<Range> ranges_;	//各図形の頂点がどこにあるか
+	public:
+		void build(const Array<Shape>& shapes) {
+			chunks_.clear();
+			ranges_.clear();
+			ranges_.reserve(shapes.size());
+			for (const auto& [polygon, color] : shapes) {
+				const auto& vertices = polygon.vertices();
+				const auto& indices = polygon.indices();
+				if (chunks_.empty() || MaxVertices < chunks_.back().vertices.size() + vertices.size()) {
+					chunks_.emplace_back();
+				}
+				auto& chunk = chunks_.back();
+				const auto base = static_cast<Vertex2D::IndexType>(chunk.vertices.size());
+				ranges_ << Range{ static_cast<uint32>(chunks_.size() - 1), base };
+
+				const Float4 c = color.toFloat4();
+				for (const auto& v : vertices) {
+					chunk.vertices << Vertex2D{ Float2(v.x, v.y), Float2::Zero(), c };
+				}
+				for (const auto& i : indices) {
+					chunk.indices << TriangleIndex{
+						static_cast<Vertex2D::IndexType>(base + i.i0),
+						static_cast<Vertex2D::IndexType>(base + i.i1),
+						static_cast<Vertex2D::IndexType>(base + i.i2) };
+				}
+			}
+		}
+
+		//動かした図形の頂点だけ書き直す
+		void update(const Array<Shape>& shapes, int32 index) {
+			const auto& [chunk, begin] = ranges_[index];
+			Vertex2D* v = chunks_[chunk].vertices.data() + begin;
+			for (const auto& p : shapes[index].polygon.vertices()) {
+				(v++)->pos = Float2(p.x, p.y);
+			}
+		}
+
+		void draw() const {
+			for (const auto& chunk : chunks_) {
+				chunk.draw();
+			}
+		}
+		//頂点色を乗算で消してから加算で単色にする
+		void drawShadow(const Vec2& offset, const ColorF& color) const {
+			const Transformer2D t(Mat3x2::Translate(offset));
+			const ScopedColorMul2D mul(ColorF(0.0, color.a));
+			const ScopedColorAdd2D add(ColorF(color.rgb(), 0.0));
+			draw();
+		}
+	};
+
+	Array<Shape> shapes;
+	ShapeIndex shape_index;
+	ShapeMesh shape_mesh;
+	int32 target_index;
+	Optional<int32> grab_index;	//クリック
+	Optional<int32> hold_index;	//0.15秒以上ホールド
+	//図形の配置の難しさ
+	struct Placement {
+		double spacing = 0.8;	//中心同士の最小間隔。密に詰めたときの間隔に対する比(0なら一様乱数)
+		double max_occlusion = 0.5;	//ターゲットが手前の図形に隠されてよい面積の割合
+
+		bool operator==(const Placement&) const = default;
+	};
+
+	//Bridson法によるPoisson-disk sampling。近傍は空間ハッシュ(一様グリッド)で引くのでO(n)
+	//間隔が大きすぎてn個置けなかった分は一様乱数で埋める
+	Array<Vec2> PoissonDiskSample(const RectF& area, int32 n, double spacing, DefaultRNG& rng) {
+		Array<Vec2> points;
+		if (n <= 0) {
+			return points;
+		}
+		points.reserve(n);
+
+		const double r = spacing * 0.85 * Sqrt(area.area() / Max(n, 1));	//Bridson法の充填率でおおよそn個入る半径
+		if (r > 0.0) {
+			constexpr int32 Tries = 30;
+			const double cell = r / Math::Sqrt2;
+			const Size grid_size(static_cast<int32>(Ceil(area.w / cell)), static_cast<int32>(Ceil(area.h / cell)));
+			Grid<int32> grid(grid_size, -1);
+			Array<int32> active;
+			const auto cellOf = [&](const Vec2& p) {
+				return Point(Clamp(static_cast<int32>((p.x - area.x) / cell), 0, grid_size.x - 1),
+					Clamp(static_cast<int32>((p.y - area.y) / cell), 0, grid_size.y - 1));
+			};
+			const auto add = [&](const Vec2& p) {
+				grid[cellOf(p)] = static_cast<int32>(points.size());
+				active << static_cast<int32>(points.size());
+				points << p;
+			};
+			const auto isFar = [&](const Vec2& p) {
+				const Point c = cellOf(p);
+				for (int32 y = Max(c.y - 2, 0); y <= Min(c.y + 2, grid_size.y - 1); ++y) {
+					for (int32 x = Max(c.x - 2, 0); x <= Min(c.x + 2, grid_size.x - 1); ++x) {
+						if (const int32 i = grid[y][x]; i >= 0 && points[i].distanceFromSq(p) < r * r) {
+							return false;
+						}
+					}
+				}
+				return true;
+			};
+
+			add(Vec2(Random(area.x, area.x + area.w, rng), Random(area.y, area.y + area.h, rng)));
+			while (not active.empty() && static_cast<int32>(points.size()) < n) {
+				const size_t a = Random(active.size() - 1, rng);
+				const Vec2 base = points[active[a]];
+				bool found = false;
+				for ([[maybe_unused]] int32 t : step(Tries)) {
+					const Vec2 p = base + Circular(Random(r, 2 * r, rng), Random(Math::TwoPi, rng)).toVec2();
+					if (area.intersects(p) && isFar(p)) {
+						add(p);
+						found = true;
+						break;
+					}
+				}
+				if (not found) {
+					active[a] = active.back();
+					active.pop_back();
+				}
+			}
+		}
+
+		while (static_cast<int32>(points.size()) < n) {
+			points << Vec2(Random(area.x, area.x + area.w, rng), Random(area.y, area.y + area.h, rng));
+		}
+		//生成順は塊になっているので、描画順が偏らないように混ぜる
+		points.shuffle(rng);
+		return points;
+	}
+
+	//ターゲットのうち手前の図形に隠されている割合をサンプリングで見積もる
+	double EstimateOcclusion(const Array<Shape>& shapes, const ShapeIndex& index, int32 target, DefaultRNG& rng) {
+		constexpr int32 Samples = 64;
+		const auto& polygon = shapes[target].polygon;
+		const RectF rect = polygon.boundingRect();
+		int32 inside = 0, hidden = 0;
+		for ([[maybe_unused]] int32 i : step(Samples * 4)) {
+			const Vec2 p(Random(rect.x, rect.x + rect.w, rng), Random(rect.y, rect.y + rect.h, rng));
+			if (not polygon.intersects(p)) {
+				continue;
+			}
+			++inside;
+			if (const auto top = index.topmostAt(shapes, p); top && *top > target) {
+				++hidden;
+			}
+			if (inside >= Samples) {
+				break;
+			}
+		}
+		return inside ? static_cast<double>(hidden) / inside : 0.0;
+	}
+
+	struct Round {
+		Array<Shape> shapes;
+		ShapeIndex index;
+		ShapeMesh mesh;
+		int32 target_index = 0;
+	};
+	//1ラウンド分の図形を作る。ワーカースレッドで呼ぶのでグローバルには触らない
+	Round GenerateRound(int32 shapenum, const Placement& placement, uint64 seed) {
+		DefaultRNG rng(seed);
+		Round round;
+		round.shapes.reserve(shapenum);
+		for (const auto& center : PoissonDiskSample(RectF(0, 0, 800, 600), shapenum, placement.spacing, rng)) {
+			const double angle = Random(Math::TwoPi, rng);
+			const ColorF color(Random(1.0, rng), Random(1.0, rng), Random(1.0, rng));
+			switch (Random(3, rng)) {
+			case 0:
+			{
+				const Triangle triangle(center, 100);
+				round.shapes << Shape{ triangle.rotatedAt(center,angle).asPolygon(),color };
+				break;
+			}
+			case 1:
+			{
+				const RectF rect(Arg::center = center, 60, 80);
+				round.shapes << Shape{ rect.rotatedAt(center,angle).asPolygon(),color };
+				break;
+			}
+			case 2:
+			{
+				const auto star = Shape2D::Star(50, center, angle);
+				round.shapes << Shape{ star.asPolygon(),color };
+				break;
+			}
+			case 3:
+			{
+				const auto plus = Shape2D::Plus(50, 20, center, angle);
+				round.shapes << Shape{ plus.asPolygon(),color };
+				break;
+			}
+			}
+		}
+		round.index.build(round.shapes);
+
+		//隠れすぎていない図形をターゲットにする。見つからなければ最前面に移す
+		constexpr int32 Candidates = 16;
+		Optional<int32> target;
+		for ([[maybe_unused]] int32 i : step(Candidates)) {
+			const auto candidate = static_cast<int32>(Random(round.shapes.size() - 1, rng));
+			if (EstimateOcclusion(round.shapes, round.index, candidate, rng) <= placement.max_occlusion) {
+				target = candidate;
+				break;
+			}
+		}
+		if (not target) {
+			const auto candidate = static_cast<int32>(Random(round.shapes.size() - 1, rng));
+			std::rotate(round.shapes.begin() + candidate, round.shapes.begin() + candidate + 1, round.shapes.end());
+			target = static_cast<int32>(round.shapes.size() - 1);
+			round.index.build(round.shapes);
+		}
+		round.target_index = *target;
+		round.mesh.build(round.shapes);
+		return round;
+	}
+
+	//ラウンド生成をワーカースレッドで行い、次のラウンドも先回りして作っておく
+	class RoundGenerator {
+		using Key = std::pair<int32, Placement>;
+		struct KeyHash {
+			size_t operator()(const Key& key) const {
+				return std::hash<int32>{}(key.first)
+					^ (std::hash<double>{}(key.second.spacing) * 31) ^ (std::hash<double>{}(key.second.max_occlusion) * 961);
+			}
+		};
+		HashTable<Key, AsyncTask<Round>, KeyHash> prefetched_;	//図形数と配置ごとに1つ。AsyncTaskは破棄すると完了を待つので捨てない
+	public:
+		AsyncTask<Round> acquire(int32 shapenum, const Placement& placement) {
+			if (auto it = prefetched_.find(Key{ shapenum, placement }); it != prefetched_.end()) {
+				AsyncTask<Round> task = std::move(it->second);
+				prefetched_.erase(it);
+				return task;
+			}
+			return launch(shapenum, placement);
+		}
+		void prefetch(int32 shapenum, const Placement& placement) {
+			if (const Key key{ shapenum, placement }; not prefetched_.contains(key)) {
+				prefetched_.emplace(key, launch(shapenum, placement));
+			}
+		}
+
+	private:
+		static AsyncTask<Round> launch(int32 shapenum, const Placement& placement) {
+			return Async(GenerateRound, shapenum, placement, RandomUint64());	//シードはメインスレッドの乱数から
+		}
+	};
+	RoundGenerator round_generator;
+
+	class GameScene1 :public Yeah::Scenes::IScene {
+		const Yeah::Assets::StaticText title_{ 100, U"探せ！" };
+		Timer timer{ 3s, StartImmediately::No, Yeah::Inputs::Clock() };	//ラウンドを受け取ってから動かす
+		int32 shapenum_;
+		Placement placement_;
+		AsyncTask<Round> round_;
+		bool ready_ = false;
+	public:
+		GameScene1(int32 shapenum, const Placement& placement = {}) :
+			shapenum_(shapenum),
+			placement_(placement) {}
+		void initialize() override {
+			timer.reset();
+			ready_ = false;
+			round_ = round_generator.acquire(shapenum_, placement_);	//前のシーンのフェードアウト中に生成が進む
+		}
+
+		void update() override {
+			if (not ready_ && Yeah::Inputs::Ready(round_)) {
+				Round round = round_.get();
+				shapes = std::move(round.shapes);
+				shape_index = std::move(round.index);
+				shape_mesh = std::move(round.mesh);
+				target_index = round.target_index;
+				grab_index = hold_index = none;
+				ready_ = true;
+				timer.restart();
+
+				round_generator.prefetch(shapenum_, placement_);	//遊んでいる間に次のラウンドを作る
+			}
+
+			if (ready_ && timer.reachedZero()) {
+				changeScene(
+					SceneFactory::Create<GameScene2>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.1s, 0.1s)
+				);
+			}
+		}
+		void draw() const override {
+			title_.drawAt({ 400,200 });
+			if (not ready_) {
+				return;
+			}
+			const auto& target = shapes[target_index];
+			const Transformer2D t(Mat3x2::Translate(-target.polygon.centroid()).scaled(0.6 * (2 + Periodic::Sine0_1(2s))).translated(400, 400));
+			target.polygon.draw(target.color);
+		}
+	};
+	class GameScene2 :public Yeah::Scenes::IScene {
+		const Yeah::Assets::FontRef font{ 100 };
+		Optional<int32> mouseover_index;
+	public:
+		void update() override {
+			mouseover_index = shape_index.topmostAt(shapes, Yeah::Inputs::CursorPos());
+			if (mouseover_index && Yeah::Inputs::MouseL.down()) {
+				grab_index = *mouseover_index;
+			}
+			if (grab_index && Yeah::Inputs::MouseL.pressedDuration() > 0.15s) {
+				hold_index = *grab_index;
+			}
+			if (grab_index && Yeah::Inputs::MouseL.up()) {
+				if (not hold_index) {
+					changeScene(
+						SceneFactory::Create<Result>(*grab_index == target_index),
+						TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+					);
+				}
+				grab_index = hold_index = none;
+			}
+
+			if (hold_index) {
+				shapes[*hold_index].polygon.moveBy(Yeah::Inputs::CursorPos() - shapes[*hold_index].polygon.centroid());
+				shape_index.update(shapes, *hold_index);
+				shape_mesh.update(shapes, *hold_index);
+			}
+		}
+		void draw() const override {
+			shape_mesh.drawShadow(Vec2(3, 3), ColorF(Palette::Lightblue, 0.5));
+			shape_mesh.draw();
+			if (mouseover_index) {
+				shapes[*mouseover_index].polygon.drawFrame(3, Palette::Yellow);
+				//Print << (*mouseover_index == target_index);
+			}
+		}
+	};
+	class Result :public Yeah::Scenes::IScene {
+		const Yeah::Assets::FontRef font{ 100 };
+		const bool success_ = false;
+	public:
+		Result() {}
+		Result(bool success) :
+			success_(success) {}
+		void update() override {
+			if (Yeah::GUI::ButtonAt(U"答え", { 400,400 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Answer>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+			if (Yeah::GUI::ButtonAt(U"戻る", { 400,450 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Title>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+		}
+		void draw() const override {
+			font(success_ ? U"クリア！！！" : U"残念！").drawAt({ 400,180 });
+		}
+	};
+	class Answer :public Yeah::Scenes::IScene {
+		SaturatedLinework<Circle> linework_{ Circle(shapes[target_index].polygon.centroid(),100) };
+		mutable std::function<void()> delay;
+	public:
+		void update() override {
+			if (delay) {
+				delay();
+				delay = decltype(delay)();
+			}
+
+			linework_.generate();
+		}
+		void draw() const override {
+			shape_mesh.drawShadow(Vec2(3, 3), ColorF(Palette::Lightblue, 0.5));
+			shape_mesh.draw();
+			shapes[target_index].polygon.drawFrame(5, Palette::Yellow);
+			linework_.draw();
+
+			if (Yeah::GUI::Button(U"戻る", { 0,0 }, 70)) {
+				delay = [this]() mutable {
+					const_cast<Answer*>(this)->undo(TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s));
+				};
+			}
+		}
+	};
+}
+namespace TenSecondsTimer {
+	//結果画面に出すこれまでの成績(秒)。スケッチそのものは大きいので要約だけ渡す
+	struct Summary {
+		uint64 count = 0;
+		double mean = 0.0, sd = 0.0;
+		double p10 = 0.0, p50 = 0.0, p90 = 0.0;
+
+		static Summary From(const ReactionStats::Sketch& sketch) {
+			return Summary{
+				sketch.running.count,
+				sketch.running.mean / 1e6,
+				Sqrt(sketch.running.variance()) / 1e6,
+				sketch.histogram.quantile(0.1) / 1e6,
+				sketch.histogram.quantile(0.5) / 1e6,
+				sketch.histogram.quantile(0.9) / 1e6,
+			};
+		}
+	};
+
+	//時計の絵文字12枚。テクスチャは各シーンで共有する
+	class Clocks {
+		static constexpr std::array<StringView, 12> Faces = {
+			U"🕛", U"🕐", U"🕑", U"🕒", U"🕓", U"🕔", U"🕕", U"🕖", U"🕗", U"🕘", U"🕙", U"🕚",
+		};
+		std::array<Yeah::Assets::EmojiRef, 12> textures_ = {
+			Yeah::Assets::EmojiRef{ String(Faces[0]) }, Yeah::Assets::EmojiRef{ String(Faces[1]) },
+			Yeah::Assets::EmojiRef{ String(Faces[2]) }, Yeah::Assets::EmojiRef{ String(Faces[3]) },
+			Yeah::Assets::EmojiRef{ String(Faces[4]) }, Yeah::Assets::EmojiRef{ String(Faces[5]) },
+			Yeah::Assets::EmojiRef{ String(Faces[6]) }, Yeah::Assets::EmojiRef{ String(Faces[7]) },
+			Yeah::Assets::EmojiRef{ String(Faces[8]) }, Yeah::Assets::EmojiRef{ String(Faces[9]) },
+			Yeah::Assets::EmojiRef{ String(Faces[10]) }, Yeah::Assets::EmojiRef{ String(Faces[11]) },
+		};
+	public:
+		const Texture& operator[](size_t i) const { return textures_[i].get(); }
+		static constexpr size_t size() { return Faces.size(); }
+
+		static void Preload() {
+			for (const auto& face : Faces) {
+				Yeah::Assets::Emojis().preload(String(face));
+			}
+		}
+	};
+
+	class Title :public Yeah::Scenes::IScene {
+		const Yeah::Assets::StaticText title_{ 100, U"10秒タイマー" };
+		const Clocks clocks;
+	public:
+		static constexpr StringView SessionName = U"tenseconds.title";
+		void update() override {
+			if (Yeah::GUI::ButtonAt(U"スタート", { 400,350 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Game>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+			if (Yeah::GUI::ButtonAt(U"ルール", { 400,400 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Rule>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+			if (Yeah::GUI::ButtonAt(U"戻る", { 400,450 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Second::Title>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+		}
+		void draw() const override {
+			clocks[static_cast<int32>(Yeah::Inputs::Time()) % clocks.size()].scaled(3).drawAt({ 400,300 }, ColorF(1.0, 0.1));
+			title_.drawAt({ 400,180 });
+		}
+	};
+	class Rule :public Yeah::Scenes::IScene {
+		const Yeah::Assets::StaticText title_{ 100, U"ルール" };
+		const Yeah::Assets::StaticText rule_{ 50, U"カウントダウン後にタイマーが\nスタートする\n10秒経ったらボタンを押そう" };
+		const Clocks clocks;
+	public:
+		static constexpr StringView SessionName = U"tenseconds.rule";
+		void update() override {
+			if (Yeah::GUI::ButtonAt(U"戻る", { 400,500 }, 200)) {
+				undo(TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s));
+			}
+		}
+		void draw() const override {
+			clocks[static_cast<int32>(Yeah::Inputs::Time()) % clocks.size()].scaled(3).drawAt({ 400,300 }, ColorF(1.0, 0.1));
+			title_.drawAt({ 400,120 });
+			rule_.drawAt({ 400,320 });
+		}
+	};
+	class Game :public Yeah::Scenes::IScene {
+		const Yeah::Assets::FontRef font{ 100 };
+		const Clocks clocks;
+		enum class State {
+			Wait,
+			CountDown,
+			Time,
+			Finish,
+			Size,
+		} state = State::Wait;
+		Timer count_down_{ 3s, StartImmediately::No, Yeah::Inputs::Clock() };	//表示用
+		double start_ = 0.0;	//カウントダウンがちょうど終わる時刻(Inputs::Time)
+	public:
+		Game() {
+			Yeah::Glyphs::Request(100, U"123");	//カウントダウンの数字
+		}
+		void update() override {
+			Yeah::Inputs::RequestPressTiming();	//このシーンにいる間だけ押した時刻を1ms刻みで取る
+			switch (state) {
+			case State::Wait:
+				if (Yeah::GUI::ButtonAt(U"準備OK！", { 400,300 }, 200)) {
+					state = State::CountDown;
+					count_down_.start();
+					start_ = Yeah::Inputs::MouseL.pressedAt() + count_down_.duration().count();
+				}
+				break;
+			case State::CountDown:
+				if (count_down_.reachedZero()) {
+					state = State::Time;
+				}
+				break;
+			case State::Time:
+			case State::Finish:
+				if (Yeah::GUI::ButtonAt(U"ストップ！", { 400,300 }, 200) && state == State::Time) {
+					state = State::Finish;
+					//フレームの時刻ではなく押した時刻で測る。押してからこのフレームで気づくまでが入力の遅れ
+					const double stop = Yeah::Inputs::MouseL.pressedAt();
+					const Duration duration{ stop - start_ };
+					const int64 micro = static_cast<int64>(duration.count() * 1e6);
+					const auto place = Yeah::Scores::Get().add(Yeah::Scores::GameId::TenSecondsTimer, 0, -Abs(micro - 10'000'000), micro);
+					const auto& stats = Yeah::Scores::Get().addReaction(Yeah::Scores::PlayerName(), micro - 10'000'000);
+					changeScene(
+						SceneFactory::Create<Result>(duration, Duration{ Yeah::Inputs::Time() - stop }, place, Summary::From(stats)),
+						TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+					);
+				}
+				break;
+			}
+		}
+		void draw() const override {
+			switch (state) {
+			case State::Wait:
+				clocks[static_cast<int32>(Yeah::Inputs::Time()) % clocks.size()].scaled(3).drawAt({ 400,300 }, ColorF(1.0, 0.1));
+				break;
+			case State::CountDown:
+				font(Ceil(count_down_.remaining().count())).drawAt({ 400,300 });
+				break;
+			}
+		}
+	};
+	class Result :public Yeah::Scenes::IScene {
+		const Yeah::Assets::FontRef font{ 100 }, font50{ 50 }, font20{ 20 };
+		Duration duration_;
+		Duration latency_;	//ストップを押してから気づくまで
+		Optional<size_t> place_;
+		Summary summary_;
+	public:
+		Result(const Duration& duration, const Duration& latency, const Optional<size_t>& place, const Summary& summary) :
+			duration_(duration),
+			latency_(latency),
+			place_(place),
+			summary_(summary) {}
+		void update() override {
+			if (Yeah::GUI::ButtonAt(U"もう一度", { 400,450 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Game>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+			if (Yeah::GUI::ButtonAt(U"戻る", { 400,500 }, 200)) {
+				changeScene(
+					SceneFactory::Create<Title>(),
+					TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s)
+				);
+			}
+		}
+		void draw() const override {
+			font(duration_).drawAt({ 400,250 }, Palette::White);
+			font50(Abs((duration_ - 10s).count()) <= 0.5 ? U"お見事！" : U"もう一度！").drawAt({ 400,350 }, Palette::White);
+			font20(U"入力の遅れ {:.1f} ms"_fmt(latency_.count() * 1000)).drawAt({ 400,400 }, Palette::Lightgray);
+			if (const auto& top = Yeah::Scores::Get().top(Yeah::Scores::GameId::TenSecondsTimer, 0); not top.isEmpty()) {
+				const String best = U"ベスト {:.3f}s"_fmt(top.front().value / 1e6);
+				font20(place_ ? U"ランキング {}位 / {}"_fmt(*place_ + 1, best) : best).drawAt({ 400,550 }, Palette::White);
+			}
+			font20(U"{}回 平均 {:+.3f}s ± {:.3f} / 10% {:+.3f}s 50% {:+.3f}s 90% {:+.3f}s"_fmt(
+				summary_.count, summary_.mean, summary_.sd, summary_.p10, summary_.p50, summary_.p90)).drawAt({ 400,580 }, Palette::Lightgray);
+		}
+	};
+}
+
+/*各ファクトリの定義*/
+template<typename T, typename...Args>
+std::unique_ptr<Yeah::Scenes::IScene> SceneFactory::Create(Args&&...args) {
+	Yeah::Memory::Account* account = Yeah::Memory::GetLedger().open(typeid(T).name());
+	const Yeah::Memory::Charge charge{ account };	//コンストラクタでの確保もこのシーンに付ける
+	if constexpr ((std::is_copy_constructible_v<std::decay_t<Args>> && ...)) {
+		std::tuple<std::decay_t<Args>...> params(args...);
+		std::unique_ptr<Yeah::Scenes::IScene> scene = std::make_unique<T>(std::forward<Args>(args)...);
+		scene->recreate_ = [params = std::move(params)]() {
+			return std::apply([](const auto&...a) { return SceneFactory::Create<T>(a...); }, params);
+		};
+		scene->footprint_ = sizeof(T);
+		scene->account_ = account;
+		if constexpr (requires { T::SessionName; }) {
+			scene->session_name_ = T::SessionName;
+		}
+		return scene;
+	}
+	else {
+		std::unique_ptr<Yeah::Scenes::IScene> scene = std::make_unique<T>(std::forward<Args>(args)...);
+		scene->footprint_ = sizeof(T);
+		scene->account_ = account;
+		if constexpr (requires { T::SessionName; }) {
+			scene->session_name_ = T::SessionName;
+		}
+		return scene;
+	}
+}
+template<typename T>
+std::unique_ptr<Yeah::Scenes::IScene> SceneFactory::Restore([[maybe_unused]] Yeah::Session::Reader& reader) {
+	if constexpr (not std::is_constructible_v<T, Yeah::Session::Reader&>) {
+		return Create<T>();	//状態を持たないシーン
+	}
+	else {
+		Yeah::Memory::Account* account = Yeah::Memory::GetLedger().open(typeid(T).name());
+		const Yeah::Memory::Charge charge{ account };
+		std::unique_ptr<Yeah::Scenes::IScene> scene = std::make_unique<T>(reader);
+		if (not reader.ok()) {
+			return nullptr;
+		}
+		if constexpr (std::is_default_constructible_v<T>) {
+			scene->recreate_ = []() { return SceneFactory::Create<T>(); };	//追い出されたら最初からになる
+		}
+		scene->footprint_ = sizeof(T);
+		scene->account_ = account;
+		scene->session_name_ = T::SessionName;
+		return scene;
+	}
+}
+//セッションから戻せるシーン。SessionNameはファイルに残るので変えない
+template<typename...Scenes>
+std::unique_ptr<Yeah::Scenes::IScene> RestoreOneOf(StringView name, Yeah::Session::Reader& reader) {
+	std::unique_ptr<Yeah::Scenes::IScene> scene;
+	(void)((name == Scenes::SessionName && (scene = SceneFactory::Restore<Scenes>(reader), true)) || ...);
+	return scene;
+}
+std::unique_ptr<Yeah::Scenes::IScene> SceneFactory::Restore(StringView name, Yeah::Session::Reader& reader) {
+	return RestoreOneOf<
+		Master::Title, Second::Title,
+		ConwaysGameOfLife::Title, ConwaysGameOfLife::Game,
+		BreakOut::Title, BreakOut::Game, BreakOut::Game2,
+		FindShape::Title,
+		TenSecondsTimer::Title, TenSecondsTimer::Rule
+	>(name, reader);
+}
+template<typename T, typename...Args>
+AsyncTask<std::unique_ptr<Yeah::Scenes::IScene>> SceneFactory::CreateAsync(Args&&...args) {
+	return Async([seed = RandomUint64(), params = std::make_tuple(std::decay_t<Args>(std::forward<Args>(args))...)]() {
+		Reseed(seed);	//ワーカースレッドの乱数もメインスレッドの乱数列から決める
+		const Yeah::Profiler::Scope scope{ "SceneFactory::CreateAsync", typeid(T).name() };
+		return std::apply([](const auto&...a) { return SceneFactory::Create<T>(a...); }, params);
+	});
+}
+template<typename T, typename...Args>
+std::unique_ptr<Yeah::Transitions::ITransition> TransitionFactory::Create(Args&&...args) {
+	return std::make_unique<T>(std::forward<Args>(args)...);
+}
+
+//記録を再生したときのフレームごとの処理時間。ビルド間で比べるためにCSVで書き出す
+struct FrameTimings {
+	Array<std::pair<uint64, uint64>> frames;	//update, draw (ns)
+
+	void save(FilePathView path) const {
+		CSV csv;
+		csv.writeRow(U"frame", U"update_us", U"draw_us");
+		for (const auto& [i, f] : Indexed(frames)) {
+			csv.writeRow(i, f.first / 1000.0, f.second / 1000.0);
+		}
+		csv.save(path);
+	}
+};
+//再生を始める。シーンを作る前に呼んで乱数も記録時に揃える
+Yeah::Inputs::ReplaySource& StartReplay(FilePathView path) {
+	auto source = std::make_unique<Yeah::Inputs::ReplaySource>(path);
+	auto& replay = *source;
+	Reseed(replay.seed());
+	Yeah::Inputs::SetSource(std::move(source));
+	return replay;
+}
+void ReportReplay(const Yeah::Inputs::ReplaySource& replay, const FrameTimings& timings, FilePathView path) {
+	timings.save(FilePath{ path } + U".timing.csv");
+	if (not replay.diverged().isEmpty()) {
+		Console << U"replay diverged at frame {} ({} frames)"_fmt(replay.diverged().front(), replay.diverged().size());
+	}
+	if (replay.truncated()) {
+		Console << U"replay {} ends with a truncated frame"_fmt(path);
+	}
+}
+
+#ifdef MINIGAMES_HEADLESS
+SIV3D_SET(EngineOption::Renderer::Headless)
+
+//台本(.rec なら記録)の入力を固定刻みで、描画せずに実時間より速く流す。expectが外れるか再生がずれたらfalse
+bool RunHeadless(FilePathView path) {
+	const Yeah::Inputs::ScriptSource* script = nullptr;
+	const Yeah::Inputs::ReplaySource* replay = nullptr;
+	if (FileSystem::Extension(path) == U"rec") {
+		replay = &StartReplay(path);
+	}
+	else {
+		auto source = std::make_unique<Yeah::Inputs::ScriptSource>(path);
+		script = source.get();
+		Yeah::Inputs::SetSource(std::move(source));
+	}
+
+	Yeah::SceneChanger sc(
+		SceneFactory::Create<Master::Title>(),
+		Yeah::Transitions::Compose(Yeah::Transitions::Fades::Ease(Yeah::Transitions::Fades::FadeIn(1s), EaseOutCubic))
+	);
+	const Stopwatch wall{ StartImmediately::Yes };
+	FrameTimings timings;
+	uint64 frames = 0;
+	bool passed = true;
+	while (System::Update() && Yeah::Inputs::Update()) {
+		++frames;
+		const uint64 begin = Time::GetNanosec();
+		const bool running = sc.update();
+		timings.frames.emplace_back(Time::GetNanosec() - begin, 0);
+		Yeah::Inputs::EndFrame(sc.checkpoint());
+		Yeah::Memory::GetLedger().endFrame();
+		if (not running) {
+			break;
+		}
+		if (not script) {
+			continue;
+		}
+		for (const auto& expect : script->expectations()) {
+			String current;
+			for (const auto& h : sc.history()) {
+				if (h.current) {
+					current = h.name;
+				}
+			}
+			if (not current.includes(expect)) {
+				Console << U"frame {}: expected {}, but {}"_fmt(frames, expect, current);
+				passed = false;
+			}
+		}
+	}
+	Console << U"{} frames ({:.2f} s) in {:.2f} s, worst scene entry {:.1f} ms"_fmt(frames, Yeah::Inputs::Time(), wall.sF(), sc.worstEntryHitch().count() * 1000);
+	if constexpr (not Yeah::Memory::Tracking::Enabled) {
+		Console << U"leak check skipped (build with MINIGAMES_TRACK_ALLOCATIONS)";
+	}
+	for (const auto& [name, bytes] : Yeah::Memory::GetLedger().leaks()) {
+		Console << U"leak: {} still holds {} bytes after it was dropped"_fmt(name, bytes);
+	}
+	if (replay) {
+		ReportReplay(*replay, timings, path);
+		passed = passed && replay->diverged().isEmpty() && not replay->truncated();
+	}
+	return passed;
+}
+
+//--bench で各ゲームの重い処理を計測する。--baseline の結果より有意に遅くなっていたらfalse
+namespace Bench {
+	struct Result {
+		String name;
+		size_t samples = 0;
+		double mean = 0.0, stddev = 0.0, median = 0.0;	//1回あたりのns
+	};
+
+	//t分布の両側95%点
+	inline double TCritical(double df) {
+		static constexpr double Table[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+			2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+			2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+		if (df < 1.0) {
+			return Table[0];
+		}
+		if (df <= 30.0) {
+			return Table[static_cast<size_t>(df) - 1];
+		}
+		return 1.96 + 2.5 / df;	//30より上はこの近似で十分
+	}
+	inline double HalfWidth(const Result& r) {
+		return r.samples > 1 ? TCritical(static_cast<double>(r.samples - 1)) * r.stddev / Sqrt(static_cast<double>(r.samples)) : 0.0;
+	}
+
+	class Runner {
+		Array<Result> results_;
+		String filter_;
+		size_t samples_;
+		static constexpr uint64 WarmupNs = 200'000'000, SampleNs = 5'000'000;
+	public:
+		Runner(StringView filter, size_t samples) :
+			filter_(filter),
+			samples_(Max<size_t>(samples, 2)) {}
+
+		//暖機してから、1サンプルがSampleNs以上になる回数にまとめてsamples_回測る
+		template<typename F>
+		void run(StringView name, F&& f) {
+			if (not filter_.isEmpty() && not name.includes(filter_)) {
+				return;
+			}
+			for (const uint64 begin = Time::GetNanosec(); Time::GetNanosec() - begin < WarmupNs;) {
+				f();
+			}
+			uint64 iterations = 1;
+			for (;;) {
+				const uint64 begin = Time::GetNanosec();
+				for (uint64 i = 0; i < iterations; ++i) {
+					f();
+				}
+				if (Time::GetNanosec() - begin >= SampleNs) {
+					break;
+				}
+				iterations *= 2;
+			}
+			Array<double> samples(samples_);
+			for (auto& sample : samples) {
+				const uint64 begin = Time::GetNanosec();
+				for (uint64 i = 0; i < iterations; ++i) {
+					f();
+				}
+				sample = static_cast<double>(Time::GetNanosec() - begin) / iterations;
+			}
+
+			Result r{ String{ name }, samples.size() };
+			r.mean = samples.sum() / samples.size();
+			for (const double x : samples) {
+				r.stddev += (x - r.mean) * (x - r.mean);
+			}
+			r.stddev = Sqrt(r.stddev / (samples.size() - 1));
+			samples.sort();
+			r.median = samples[samples.size() / 2];
+			Console << U"{:<32} {:>12.1f} ns ±{:>9.1f} (median {:.1f}, {} x {})"_fmt(r.name, r.mean, HalfWidth(r), r.median, r.samples, iterations);
+			results_ << r;
+		}
+		const Array<Result>& results() const {
+			return results_;
+		}
+	};
+
+	inline void Save(FilePathView path, const Array<Result>& results) {
+		CSV csv;
+		csv.writeRow(U"name", U"samples", U"mean_ns", U"stddev_ns", U"median_ns");
+		for (const auto& r : results) {
+			csv.writeRow(r.name, r.samples, r.mean, r.stddev, r.median);
+		}
+		csv.save(path);
+	}
+	inline Array<Result> Load(FilePathView path) {
+		Array<Result> results;
+		const CSV csv{ path };
+		for (size_t row = 1; row < csv.rows(); ++row) {
+			if (csv[row].size() < 5) {
+				continue;
+			}
+			results << Result{ csv[row][0], Parse<size_t>(csv[row][1]), Parse<double>(csv[row][2]), Parse<double>(csv[row][3]), Parse<double>(csv[row][4]) };
+		}
+		return results;
+	}
+
+	//Welchのt検定で有意に、かつtoleranceを超えて遅くなったものを落とす
+	inline bool Compare(const Array<Result>& baseline, const Array<Result>& results, double tolerance) {
+		bool passed = true;
+		for (const auto& r : results) {
+			const auto base = std::find_if(baseline.begin(), baseline.end(), [&](const Result& b) { return b.name == r.name; });
+			if (base == baseline.end() || base->samples < 2) {
+				continue;
+			}
+			const double va = base->stddev * base->stddev / base->samples, vb = r.stddev * r.stddev / r.samples;
+			const double se = Sqrt(va + vb);
+			const double df = (se > 0.0) ? (va + vb) * (va + vb) / (va * va / (base->samples - 1) + vb * vb / (r.samples - 1)) : 1e9;
+			const double t = (se > 0.0) ? (r.mean - base->mean) / se : 0.0;
+			const double change = r.mean / base->mean - 1.0;
+			const bool regressed = change > tolerance && t > TCritical(df);
+			Console << U"{:<32} {:+7.1f}% (t = {:.2f}){}"_fmt(r.name, change * 100, t, regressed ? U"  REGRESSION" : U"");
+			passed = passed && not regressed;
+		}
+		return passed;
+	}
+
+	//計測用の入力。毎フレーム関数で作る
+	class FeedSource :public Yeah::Inputs::ISource {
+		std::function<Yeah::Inputs::Frame()> feed_;
+	public:
+		explicit FeedSource(std::function<Yeah::Inputs::Frame()> feed) :
+			feed_(std::move(feed)) {}
+		Optional<Yeah::Inputs::Frame> next() override {
+			return feed_();
+		}
+	};
+	inline void Feed(std::function<Yeah::Inputs::Frame()> feed) {
+		Yeah::Inputs::SetSource(std::make_unique<FeedSource>(std::move(feed)));
+	}
+	inline Yeah::Inputs::Frame Idle() {
+		Yeah::Inputs::Frame frame;
+		frame.delta_time = 1.0 / 60;
+		return frame;
+	}
+
+	inline void RunAll(Runner& runner) {
+		Feed(Idle);
+
+		//ライフゲーム。ゲームと同じく並列の経路を通すよう、SceneChangerの代わりにスケジューラを置く
+		{
+			Yeah::Jobs::Scheduler scheduler;
+			Yeah::Jobs::Scheduler* const previous = Yeah::Jobs::Scheduler::SetCurrent(&scheduler);
+			for (const int32 n : { 30, 256 }) {
+				ConwaysGameOfLife::Impl life{ Size(n, n) };
+				for (auto&& i : life.cell_) {
+					i = RandomBool(0.3);
+				}
+				runner.run(U"life/step {}x{}"_fmt(n, n), [&]() { life.update(); });
+			}
+			Yeah::Jobs::Scheduler::SetCurrent(previous);
+		}
+		{
+			//Headlessのレンダラーは何もしないので、測れるのは描画命令を積むところまで
+			ConwaysGameOfLife::Impl life{ Size(30, 30) };
+			runner.run(U"life/draw submit 30x30", [&]() { life.draw(); });
+		}
+
+		//ブロック崩し。パドルがボールを追いかけ、終わったら作り直す
+		{
+			std::unique_ptr<BreakOut::Impl> game;
+			uint64 frame = 0;
+			const auto reset = [&]() {
+				game = std::make_unique<BreakOut::Impl>(Size(40, 25), Size(16, 7), 256);
+				frame = 0;
+			};
+			reset();
+			Feed([&]() {
+				Yeah::Inputs::Frame f = Idle();
+				f.cursor = Vec2(game->ball_.x, 500);
+				f.buttons = (frame++ % 2 == 0) ? 1 : 0;	//押しっぱなしではdownにならないので交互に
+				return f;
+			});
+			runner.run(U"breakout/update", [&]() {
+				Yeah::Inputs::Update();
+				if (not game->update()) {
+					reset();
+				}
+			});
+			Feed(Idle);
+		}
+		{
+			//測っている間に消えないよう寿命を長くして、一定数を動かし続ける
+			constexpr int32 Count = 20'000;
+			Yeah::Effects::ParticleSystem particles{ Count };
+			particles.emit(Vec2(400, 300), Palette::Orange, Count, 240.0, 3600s);
+			runner.run(U"breakout/simulate particles {}"_fmt(Count), [&]() {
+				particles.update(1.0 / 60);
+				particles.prepare();
+				particles.publish();
+			});
+		}
+
+		//図形探し
+		for (const int32 n : { 200, 2000 }) {
+			uint64 seed = 0;
+			runner.run(U"findshape/generate {}"_fmt(n), [&]() { FindShape::GenerateRound(n, FindShape::Placement{ 0.5, 0.6 }, ++seed); });
+		}
+		{
+			const auto round = FindShape::GenerateRound(2000, FindShape::Placement{ 0.5, 0.6 }, 1);
+			DefaultRNG rng(1);
+			volatile int32 sink = 0;	//最適化で消されないように
+			runner.run(U"findshape/pick 2000", [&]() {
+				const Vec2 pos(Random(800.0, rng), Random(600.0, rng));
+				sink = round.index.topmostAt(round.shapes, pos).value_or(-1);
+			});
+		}
+
+		//シーン切り替え
+		{
+			Yeah::SceneChanger sc(SceneFactory::Create<Master::Title>());
+			runner.run(U"scenechanger/change-undo-redo", [&]() {
+				sc.change(SceneFactory::Create<Second::Title>(), TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s));
+				sc.undo(TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s));
+				sc.redo(TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(0.4s, 0.4s));
+			});
+			sc.change(SceneFactory::Create<Master::Title>(), TransitionFactory::Create<Yeah::Transitions::AlphaFadeInOut>(1e6s, 1e6s));
+			runner.run(U"scenechanger/transition frame", [&]() {
+				Yeah::Inputs::Update();
+				sc.update();
+				sc.draw();
+				Yeah::Inputs::EndFrame(sc.checkpoint());
+			});
+		}
+	}
+}
+
+//中断したブロック崩しを続きから始めて、経過時間が止まらず進むか
+bool CheckBreakOutRestore() {
+	Bench::Feed(Bench::Idle);
+	BreakOut::Impl saved{ Size(40, 25), Size(16, 7) };
+	saved.hold = false;
+	saved.sw.start();
+	for (int32 i = 0; i < 60; ++i) {
+		Yeah::Inputs::Update();
+	}
+	Yeah::Session::Writer writer;
+	saved.save(writer);
+	const Array<Byte> bytes = std::move(writer).finish();
+
+	Yeah::Session::Reader reader{ bytes.data(), bytes.size() };
+	BreakOut::Impl restored{ Size(40, 25), Size(16, 7) };
+	restored.restore(reader);
+	const Duration at = restored.sw.elapsed();
+	for (int32 i = 0; i < 60; ++i) {
+		Yeah::Inputs::Update();
+	}
+	if (not reader.ok() || restored.sw.elapsed() <= at) {
+		Console << U"breakout restore: elapsed stayed at {:.2f} s"_fmt(restored.sw.sF());
+		return false;
+	}
+	return true;
+}
+
+//--bench [--filter 名前の一部] [--samples N] [--out 結果.csv] [--baseline 比べる.csv] [--tolerance 0.05]
+bool RunBenchmarks(const Array<String>& args) {
+	String filter;
+	size_t samples = 30;
+	FilePath out = U"bench.csv", baseline;
+	double tolerance = 0.05;
+	for (size_t i = 1; i + 1 < args.size(); ++i) {
+		if (args[i] == U"--filter") { filter = args[i + 1]; }
+		else if (args[i] == U"--samples") { samples = ParseOr<size_t>(args[i + 1], samples); }
+		else if (args[i] == U"--out") { out = args[i + 1]; }
+		else if (args[i] == U"--baseline") { baseline = args[i + 1]; }
+		else if (args[i] == U"--tolerance") { tolerance = ParseOr<double>(args[i + 1], tolerance); }
+	}
+
+	Bench::Runner runner{ filter, samples };
+	Bench::RunAll(runner);
+	Bench::Save(out, runner.results());
+	if (baseline.isEmpty()) {
+		return true;
+	}
+	return Bench::Compare(Bench::Load(baseline), runner.results(), tolerance);
+}
+#endif
+
+void Main() {
+	Yeah::Assets::Fonts().preload(100);
+	Yeah::Assets::Fonts().preload(50);
+	TenSecondsTimer::Clocks::Preload();
+
+#ifdef MINIGAMES_HEADLESS
+	const auto args = System::GetCommandLineArgs();
+	const bool bench = args.size() > 1 && args[1] == U"--bench";
+	const bool passed = bench ? RunBenchmarks(args) : RunHeadless(args.size() > 1 ? args[1] : U"headless.txt");
+	const bool restored = bench || CheckBreakOutRestore();	//台本の後に流す。Inputsの時計を台本の前に進めない
+	Yeah::Assets::Clear();
+	if (not (passed && restored)) {
+		//CIで落とす。Mainからは終了コードを返せないので、エンジンを閉じてmainから戻った後に失敗で終える
+		std::atexit([]() { std::_Exit(EXIT_FAILURE); });
+	}
+#else
+	Window::SetTitle(U"MiniGames");
+	Window::SetPos({ 1000,200 });
+	Scene::SetBackground(ColorF(0.2, 0.3, 0.4));
+
+	//--record <file> で入力を記録、--replay <file> でそれを再生する
+	const auto args = System::GetCommandLineArgs();
+	const Yeah::Inputs::ReplaySource* replay = nullptr;
+	FilePath replay_path;
+	bool recording = false;
+	for (size_t i = 1; i + 1 < args.size(); ++i) {
+		if (args[i] == U"--record") {
+			recording = true;
+			const uint64 seed = RandomUint64();
+			Reseed(seed);
+			Yeah::Inputs::SetSource(std::make_unique<Yeah::Inputs::RecordingSource>(args[i + 1], seed));
+		}
+		else if (args[i] == U"--replay") {
+			replay_path = args[i + 1];
+			replay = &StartReplay(replay_path);
+		}
+	}
+	FrameTimings timings;
+	Yeah::Latency::Probe latency;
+	if (not replay) {	//再生では記録しない
+		Yeah::Scores::Open(U"scores.log", U"scores.idx", U"reaction.stats");
+	}
+
+	//前回までに描いた文字を裏で読み込みキューに積む。--no-prewarmで先読みしない(効果の比較用)
+	AsyncTask<void> glyph_manifest;
+	if (args.includes(U"--no-prewarm")) {
+		Yeah::Glyphs::SetEnabled(false);
+	}
+	else {
+		glyph_manifest = Async([]() { Yeah::Glyphs::LoadManifest(U"glyphs.txt"); });
+	}
+
+	//前回の続きから始める。記録と再生は入力を合わせるため最初から
+	Optional<Yeah::Session::Saver> session;
+	if (not replay && not recording) {
+		session.emplace(U"session.bin", 5s);
+	}
+	const auto opening = []() {
+		return Yeah::Transitions::Compose(Yeah::Transitions::Fades::Ease(Yeah::Transitions::Fades::FadeIn(1s), EaseOutCubic));
+	};
+	Yeah::SceneChanger sc;
+	if (not session || not sc.resume(U"session.bin", opening())) {
+		sc.change(SceneFactory::Create<Master::Title>(), opening());
+	}
+	const Font debug_font{ 14 };
+	Yeah::Profiler::Report profile;
+	Yeah::Capture::Format capture_format = Yeah::Capture::Format::QOI;
+	while (System::Update()) {
+		latency.frameBegin();
+		if (const auto& recorder = Yeah::Capture::Instance()) {	//前のフレームの画面を録画に回す
+			recorder->update();
+		}
+		if (not Yeah::Inputs::Update()) {
+			break;	//再生し終わった
+		}
+		latency.inputSampled();
+		const uint64 begin = Time::GetNanosec();
+		const bool running = sc.update();
+		const uint64 updated = Time::GetNanosec();
+		latency.updated();
+		Yeah::Inputs::EndFrame(sc.checkpoint());
+		if (not running) {
+			break;
+		}
+		sc.draw();
+		latency.drawn();	//ここまでがゲームの仕事。下のデバッグ表示は入れない
+		if (replay) {
+			timings.frames.emplace_back(updated - begin, Time::GetNanosec() - updated);
+		}
+		if (session && session->due()) {
+			session->save(sc.snapshot());
+		}
+		Yeah::Assets::PrewarmGlyphs(2ms);
+
+		profile.collect();
+		if (KeyF3.down()) {	//計測の開始・停止
+			Yeah::Profiler::SetEnabled(not Yeah::Profiler::IsEnabled());
+			if (Yeah::Profiler::IsEnabled()) {
+				profile.clear();
+			}
+		}
+		if (KeyF4.down()) {
+			profile.exportChromeTrace(U"profile.json");
+		}
+		if (KeyF5.down()) {	//updateと並行してsimulateを回すか
+			sc.setPipelined(not sc.isPipelined());
+		}
+		if (KeyF6.down()) {	//フレームの待ち方を順に切り替える
+			latency.setPacing(static_cast<Yeah::Latency::Pacing>((static_cast<int32>(latency.pacing()) + 1) % 3));
+		}
+		if (KeyF7.down()) {	//録画の開始・停止。captures/に書き出す
+			auto& recorder = Yeah::Capture::Get();
+			if (recorder.isRecording()) {
+				recorder.stop();
+				Window::SetTitle(U"MiniGames");
+			}
+			else {
+				recorder.start(capture_format, U"captures");
+			}
+		}
+		if (KeyF8.down() && not (Yeah::Capture::Instance() && Yeah::Capture::Instance()->isRecording())) {	//録画の形式を順に切り替える
+			capture_format = static_cast<Yeah::Capture::Format>((static_cast<int32>(capture_format) + 1) % 3);
+			Window::SetTitle(U"MiniGames (capture: {})"_fmt(Yeah::Capture::ToString(capture_format)));
+		}
+		//録画中の表示は画面に描くと映り込むのでタイトルに出す
+		if (const auto& recorder = Yeah::Capture::Instance(); recorder && recorder->isRecording() && Scene::FrameCount() % 30 == 0) {
+			Window::SetTitle(U"MiniGames [REC {}] {} frames, {} written, {} dropped, {} failed"_fmt(
+				Yeah::Capture::ToString(*recorder->format()), recorder->frames(), recorder->written(), recorder->dropped(), recorder->failed()));
+		}
+		if (KeyF2.pressed()) {	//入力の遅れ
+			latency.draw(debug_font, { 10, Scene::Height() - 300 });
+		}
+		if (Yeah::Profiler::IsEnabled()) {
+			profile.draw(debug_font, { 10, Scene::Height() - 200 });
+		}
+
+		if (KeyF1.pressed()) {	//シーン履歴とメモリ使用量
+			const auto history = sc.history();
+			for (const auto& [i, h] : Indexed(history)) {
+				debug_font(U"{}{} {}"_fmt(h.current ? U"> " : U"  ", h.name, h.alive ? U"{} KB (heap {} KB, peak {} KB)"_fmt(h.bytes / 1024, h.live_bytes / 1024, h.peak_bytes / 1024) : U"(evicted)"))
+					.draw(10, 10 + i * 18, h.alive ? Palette::White : Palette::Gray);
+			}
+			debug_font(U"total {} KB / heap allocs per change {} (all {}) / pipeline {}"_fmt(sc.memoryUsage() / 1024, sc.heapAllocationsPerChange(), Yeah::Memory::GetStats().heap_allocations.load(), sc.isPipelined() ? U"on" : U"off"))
+				.draw(10, 10 + history.size() * 18, Palette::Yellow);
+			const auto perFrame = Yeah::Memory::GetLedger().allocationsPerFrame();
+			debug_font(Yeah::Memory::Tracking::Enabled
+				? U"allocs/frame update {} draw {} simulate {} other {} / transition {} KB, shared {} KB"_fmt(
+					perFrame[1], perFrame[2], perFrame[3], perFrame[0],
+					Yeah::Memory::TransitionAccount().liveBytes() / 1024, Yeah::Memory::Shared().liveBytes() / 1024)
+				: String{ U"allocation tracking off (build with MINIGAMES_TRACK_ALLOCATIONS)" })
+				.draw(10, 28 + history.size() * 18, Palette::Yellow);
+			debug_font(U"scene entry {:.1f} ms (worst {:.1f} ms) / glyphs pending {}"_fmt(
+				sc.entryHitch().count() * 1000, sc.worstEntryHitch().count() * 1000, Yeah::Glyphs::Pending()))
+				.draw(10, 46 + history.size() * 18, Palette::Yellow);
+			for (const auto& [i, leak] : Indexed(Yeah::Memory::GetLedger().leaks())) {
+				debug_font(U"leak? {} {} KB"_fmt(leak.first, leak.second / 1024)).draw(10, 64 + (history.size() + i) * 18, Palette::Orange);
+			}
+		}
+		Yeah::Memory::GetLedger().endFrame();
+		latency.waitForPresent();
+	}
+
+	if (replay) {
+		ReportReplay(*replay, timings, replay_path);
+	}
+	if (session) {
+		session->flush(sc.snapshot());
+	}
+	if (glyph_manifest.isValid()) {
+		glyph_manifest.wait();
+	}
+	Yeah::Glyphs::SaveManifest(U"glyphs.txt");
+	Yeah::Capture::Instance().reset();	//積んだフレームを書き終えるまで待つ
+	Yeah::Scores::Instance().reset();	//索引を書いて閉じる
+	Yeah::Assets::Clear();
+#endif
+}
@@ -0,0 +1,254 @@
+#pragma once
+#include<algorithm>
+#include<array>
+#include<cmath>
+#include<cstdint>
+#include<cstdio>
+#include<filesystem>
+#include<fstream>
+#include<limits>
+#include<map>
+#include<string>
+#include<system_error>
+
+//10秒タイマーの誤差(μs)の統計。1回ごとにO(1)で足せてメモリは一定、別々に集めたものを後から合わせられる
+//Siv3Dに依存しないので集計用のツール(tools/merge_stats.cpp)からも使う
+namespace ReactionStats {
+	//平均と分散。足すのはWelford、合わせるのはChanの方法
+	struct Running {
+		uint64_t count = 0;
+		double mean = 0.0;
+		double m2 = 0.0;
+		double min = std::numeric_limits<double>::infinity();
+		double max = -std::numeric_limits<double>::infinity();
+
+		void add(double x) {
+			++count;
+			const double delta = x - mean;
+			mean += delta / count;
+			m2 += delta * (x - mean);
+			min = std::min(min, x);
+			max = std::max(max, x);
+		}
+		void merge(const Running& other) {
+			if (other.count == 0) {
+				return;
+			}
+			const double n = static_cast<double>(count + other.count);
+			const double delta = other.mean - mean;
+			m2 += other.m2 + delta * delta * count * other.count / n;
+			mean += delta * other.count / n;
+			count += other.count;
+			min = std::min(min, other.min);
+			max = std::max(max, other.max);
+		}
+		double variance() const {
+			return count > 1 ? m2 / (count - 1) : 0.0;
+		}
+	};
+
+	//符号つきの対数ヒストグラム(HDR Histogramと同じ作り)。2の累乗ごとに32分割するので相対誤差は約3%
+	class Histogram {
+	public:
+		static constexpr int SubBits = 5;
+		static constexpr int SubCount = 1 << SubBits;
+		static constexpr int MaxExponent = 40;	//2^40μs(約12日)まで。それ以上は最後のバケツ
+		static constexpr size_t BucketCount = SubCount + (MaxExponent - SubBits) * SubCount;
+
+	private:
+		std::array<uint64_t, BucketCount> negative_{}, positive_{};
+		uint64_t total_ = 0;
+
+	public:
+		void add(int64_t value, uint64_t count = 1) {
+			const uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+			(value < 0 ? negative_ : positive_)[Index(magnitude)] += count;
+			total_ += count;
+		}
+		void merge(const Histogram& other) {
+			for (size_t i = 0; i < BucketCount; ++i) {
+				negative_[i] += other.negative_[i];
+				positive_[i] += other.positive_[i];
+			}
+			total_ += other.total_;
+		}
+		uint64_t total() const {
+			return total_;
+		}
+
+		//qは0〜1。小さい方(負で絶対値が大きい方)から数える
+		double quantile(double q) const {
+			if (total_ == 0) {
+				return 0.0;
+			}
+			const uint64_t rank = std::min(static_cast<uint64_t>(q * total_), total_ - 1);
+			uint64_t seen = 0;
+			for (size_t i = BucketCount; i-- > 0;) {
+				if ((seen += negative_[i]) > rank) {
+					return -Middle(i);
+				}
+			}
+			for (size_t i = 0; i < BucketCount; ++i) {
+				if ((seen += positive_[i]) > rank) {
+					return Middle(i);
+				}
+			}
+			return Middle(BucketCount - 1);
+		}
+
+		template<typename F>
+		void forEachBucket(F&& f) const {	//f(負か, 番号, 数)。空のバケツは飛ばす
+			for (size_t i = 0; i < BucketCount; ++i) {
+				if (negative_[i]) { f(true, i, negative_[i]); }
+				if (positive_[i]) { f(false, i, positive_[i]); }
+			}
+		}
+		void setBucket(bool negative, size_t index, uint64_t count) {
+			if (index >= BucketCount) {
+				return;
+			}
+			auto& bucket = (negative ? negative_ : positive_)[index];
+			total_ += count - bucket;
+			bucket = count;
+		}
+
+		static size_t Index(uint64_t magnitude) {
+			if (magnitude < SubCount) {
+				return static_cast<size_t>(magnitude);
+			}
+			int exponent = 0;
+			while ((magnitude >> exponent) >= 2 * SubCount) {
+				++exponent;
+			}
+			const size_t index = SubCount + exponent * SubCount + static_cast<size_t>((magnitude >> exponent) - SubCount);
+			return std::min(index, BucketCount - 1);
+		}
+		//バケツの範囲の真ん中
+		static double Middle(size_t index) {
+			if (index < SubCount) {
+				return static_cast<double>(index);
+			}
+			const int exponent = static_cast<int>((index - SubCount) / SubCount);
+			const double low = std::ldexp(static_cast<double>(SubCount + (index - SubCount) % SubCount), exponent);
+			return low + std::ldexp(0.5, exponent);
+		}
+	};
+
+	struct Sketch {
+		Running running;
+		Histogram histogram;
+
+		void add(int64_t errorMicrosec) {
+			running.add(static_cast<double>(errorMicrosec));
+			histogram.add(errorMicrosec);
+		}
+		void merge(const Sketch& other) {
+			running.merge(other.running);
+			histogram.merge(other.histogram);
+		}
+	};
+
+	//プレイヤー名(UTF-8)ごと
+	using Book = std::map<std::string, Sketch>;
+
+	inline void Merge(Book& to, const Book& from) {
+		for (const auto& [player, sketch] : from) {
+			to[player].merge(sketch);
+		}
+	}
+
+	//"YEAHSTA1" 人数(uint32)
+	//  人ごとに 名前の長さ(uint32) 名前 count(uint64) mean m2 min max(double) 空でないバケツの数(uint32)
+	//  バケツごとに 負か(uint8) 番号(uint16) 数(uint64)
+	//リトルエンディアンの環境どうしでだけやり取りする
+	constexpr char Magic[8] = { 'Y', 'E', 'A', 'H', 'S', 'T', 'A', '1' };
+
+	namespace detail {
+		template<typename T>
+		void Write(std::ostream& out, const T& value) {
+			out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+		template<typename T>
+		bool Read(std::istream& in, T& value) {
+			return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+		}
+	}
+
+	//一時ファイルに書いてから置き換える。途中で落ちても元のファイルか新しいファイルのどちらかが残る
+	inline bool Save(const std::string& path, const Book& book) {
+		const std::string temporary = path + ".tmp";
+		{
+			std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+			if (not out) {
+				return false;
+			}
+			out.write(Magic, sizeof(Magic));
+			detail::Write(out, static_cast<uint32_t>(book.size()));
+			for (const auto& [player, sketch] : book) {
+				detail::Write(out, static_cast<uint32_t>(player.size()));
+				out.write(player.data(), player.size());
+				const auto& r = sketch.running;
+				detail::Write(out, r.count);
+				detail::Write(out, r.mean);
+				detail::Write(out, r.m2);
+				detail::Write(out, r.min);
+				detail::Write(out, r.max);
+				uint32_t buckets = 0;
+				sketch.histogram.forEachBucket([&](bool, size_t, uint64_t) { ++buckets; });
+				detail::Write(out, buckets);
+				sketch.histogram.forEachBucket([&](bool negative, size_t index, uint64_t count) {
+					detail::Write(out, static_cast<uint8_t>(negative));
+					detail::Write(out, static_cast<uint16_t>(index));
+					detail::Write(out, count);
+				});
+			}
+			if (not out) {
+				return false;
+			}
+		}
+		std::error_code error;	//std::renameと違い、Windowsでも置き換える
+		std::filesystem::rename(std::filesystem::path(temporary), std::filesystem::path(path), error);
+		return not error;
+	}
+
+	inline bool Load(const std::string& path, Book& book) {
+		std::ifstream in(path, std::ios::binary);
+		if (not in) {
+			return false;
+		}
+		char magic[sizeof(Magic)] = {};
+		uint32_t players = 0;
+		if (not in.read(magic, sizeof(magic)) || not std::equal(std::begin(magic), std::end(magic), std::begin(Magic))
+			|| not detail::Read(in, players)) {
+			return false;
+		}
+		Book loaded;
+		for (uint32_t p = 0; p < players; ++p) {
+			uint32_t length = 0;
+			if (not detail::Read(in, length) || length > 1024) {
+				return false;
+			}
+			std::string player(length, '\0');
+			Sketch sketch;
+			auto& r = sketch.running;
+			uint32_t buckets = 0;
+			if (not in.read(player.data(), length)
+				|| not detail::Read(in, r.count) || not detail::Read(in, r.mean) || not detail::Read(in, r.m2)
+				|| not detail::Read(in, r.min) || not detail::Read(in, r.max) || not detail::Read(in, buckets)) {
+				return false;
+			}
+			for (uint32_t b = 0; b < buckets; ++b) {
+				uint8_t negative = 0;
+				uint16_t index = 0;
+				uint64_t count = 0;
+				if (not detail::Read(in, negative) || not detail::Read(in, index) || not detail::Read(in, count)) {
+					return false;
+				}
+				sketch.histogram.setBucket(negative != 0, index, count);
+			}
+			loaded[player].merge(sketch);
+		}
+		book = std::move(loaded);
+		return true;
+	}
+}
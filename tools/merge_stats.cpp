@@ -0,0 +1,35 @@
+//別々のマシン・セッションで集めた10秒タイマーの統計(reaction.stats)を1つにまとめて、プレイヤーごとに表示する
+//  g++ -std=c++17 -O2 merge_stats.cpp -o merge_stats
+//  merge_stats <出力> <入力>...
+#include"../ReactionStats.hpp"
+#include<cstdio>
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		std::fprintf(stderr, "usage: %s <out> <in>...\n", argv[0]);
+		return 2;
+	}
+
+	ReactionStats::Book merged;
+	for (int i = 2; i < argc; ++i) {
+		ReactionStats::Book book;
+		if (not ReactionStats::Load(argv[i], book)) {
+			std::fprintf(stderr, "cannot read %s\n", argv[i]);
+			return 1;
+		}
+		ReactionStats::Merge(merged, book);
+	}
+	if (not ReactionStats::Save(argv[1], merged)) {
+		std::fprintf(stderr, "cannot write %s\n", argv[1]);
+		return 1;
+	}
+
+	for (const auto& [player, sketch] : merged) {
+		const auto& r = sketch.running;
+		const auto& h = sketch.histogram;
+		std::printf("%s: n=%llu mean=%+.3fs sd=%.3fs p10=%+.3fs p50=%+.3fs p90=%+.3fs\n",
+			player.c_str(), static_cast<unsigned long long>(r.count),
+			r.mean / 1e6, std::sqrt(r.variance()) / 1e6,
+			h.quantile(0.1) / 1e6, h.quantile(0.5) / 1e6, h.quantile(0.9) / 1e6);
+	}
+}